@@ -1,14 +1,27 @@
 #include "bash.h"
+#if(STREAM_FRAME)
+  #include "frame.h"
+#endif
 
 //------------------------------------------------------------------------------------------------- STRUCT
 
+typedef struct {
+  uint32_t hash;
+  FILE_t *file;
+} BASH_File_t;
+
+typedef struct {
+  uint32_t hash;
+  void (*callback)(char **, uint16_t);
+} BASH_Callback_t;
+
 static struct {
-  FILE_t *files[BASH_FILE_LIMIT];
-  uint32_t files_hash[BASH_FILE_LIMIT];
-  uint8_t files_count;
-  void (*callbacks[BASH_CALLBACK_LIMIT])(char **, uint16_t);
-  uint32_t callbacks_hash[BASH_CALLBACK_LIMIT];
-  uint8_t callbacks_count;
+  BASH_File_t *files; // Sorted by hash
+  uint16_t files_count;
+  uint16_t files_limit;
+  BASH_Callback_t *callbacks; // Sorted by hash
+  uint16_t callbacks_count;
+  uint16_t callbacks_limit;
   void (*callback_default)(char **, uint16_t);
   bool flash_autosave;
   FILE_t *file_active;
@@ -17,27 +30,80 @@ static struct {
   uint16_t trig;
 } bash;
 
+/**
+ * @brief Binary search in table of entries starting with `uint32_t hash`, sorted by hash.
+ * @param table Table of entries.
+ * @param count Number of entries.
+ * @param size Size of one entry.
+ * @param hash Searched hash.
+ * @return Index of entry with `hash`, or `-(insert position) - 1` if not found.
+ */
+static int32_t BASH_Search(const void *table, uint16_t count, size_t size, uint32_t hash)
+{
+  int32_t lo = 0, hi = (int32_t)count - 1;
+  while(lo <= hi) {
+    int32_t mid = (lo + hi) >> 1;
+    uint32_t value = *(const uint32_t *)((const uint8_t *)table + mid * size);
+    if(value == hash) return mid;
+    if(value < hash) lo = mid + 1;
+    else hi = mid - 1;
+  }
+  return -lo - 1;
+}
+
+/**
+ * @brief Insert entry into sorted table, growing it on heap when full.
+ *   Entry with the same hash is replaced.
+ * @param table Pointer to table pointer (reallocated when grown).
+ * @param count Pointer to number of entries.
+ * @param limit Pointer to table capacity.
+ * @param size Size of one entry.
+ * @param entry Entry to insert, starts with `uint32_t hash`.
+ * @param initial Capacity of first allocation.
+ * @return `true` on success, `false` if out of memory.
+ */
+static bool BASH_Insert(void **table, uint16_t *count, uint16_t *limit, size_t size, const void *entry, uint16_t initial)
+{
+  int32_t pos = BASH_Search(*table, *count, size, *(const uint32_t *)entry);
+  if(pos >= 0) {
+    memcpy((uint8_t *)*table + pos * size, entry, size);
+    return true;
+  }
+  pos = -pos - 1;
+  if(*count >= *limit) {
+    uint16_t grow = *limit ? 2 * *limit : initial;
+    void *memory = heap_reloc(*table, grow * size);
+    if(!memory) return false;
+    *table = memory;
+    *limit = grow;
+  }
+  uint8_t *slot = (uint8_t *)*table + pos * size;
+  memmove(slot + size, slot, (*count - pos) * size);
+  memcpy(slot, entry, size);
+  (*count)++;
+  return true;
+}
+
 /**
  * @brief Dodaje plik do systemu BASH.
  * @param file Wskaźnik do struktury pliku do dodania.
  */
 void BASH_AddFile(FILE_t *file)
 {
-  if(bash.files_count >= BASH_FILE_LIMIT) {
-    LOG_Error("BASH Exceeded file limit (max:%u)", BASH_FILE_LIMIT);
+  BASH_File_t entry = { .hash = hash_djb2_ci(file->name), .file = file };
+  if(!BASH_Insert((void **)&bash.files, &bash.files_count, &bash.files_limit, sizeof(BASH_File_t), &entry, BASH_FILE_LIMIT)) {
+    LOG_Error("BASH No memory for file %s", file->name);
     return;
   }
-  bash.files[bash.files_count] = file;
-  bash.files_hash[bash.files_count] = hash_djb2_ci(file->name);
-  if(!bash.files_count) {
+  if(!bash.file_active) {
     bash.file_active = file;
   }
-  bash.files_count++;
   FILE_Flash_Load(file);
 }
 
 /**
  * @brief Dodaje nową komendę do systemu BASH, powiązaną z funkcją callback.
+ *   Komendy są przechowywane posortowane po hashu (wyszukiwanie binarne), tablica rośnie na stercie.
  * @param callback Funkcja obsługująca komendę
  * @param argv0 Nazwa komendy, przypisywana do funkcji callback.
  */
@@ -47,13 +113,10 @@ void BASH_AddCallback(void (*callback)(char **, uint16_t), char *argv0)
     bash.callback_default = callback;
     return;
   }
-  if(bash.callbacks_count >= BASH_CALLBACK_LIMIT) {
-    LOG_Error("BASH Exceeded callback limit (max:%u)", BASH_CALLBACK_LIMIT);
-    return;
+  BASH_Callback_t entry = { .hash = hash_djb2_ci(argv0), .callback = callback };
+  if(!BASH_Insert((void **)&bash.callbacks, &bash.callbacks_count, &bash.callbacks_limit, sizeof(BASH_Callback_t), &entry, BASH_CALLBACK_LIMIT)) {
+    LOG_Error("BASH No memory for command %s", argv0);
   }
-  bash.callbacks[bash.callbacks_count] = callback;
-  bash.callbacks_hash[bash.callbacks_count] = hash_djb2_ci(argv0);
-  bash.callbacks_count++;
 }
 
 /**
@@ -132,12 +195,8 @@ static void BASH_Data(uint8_t *data, uint16_t size, STREAM_t *stream)
 
 static FILE_t *BASH_FindFile(char *file_name)
 {
-  uint32_t file_hash = hash_djb2(file_name);
-  for(uint8_t i = 0; i < bash.files_count; i++) {
-    if(file_hash == bash.files_hash[i]) {
-      return bash.files[i];
-    }
-  }
+  int32_t idx = BASH_Search(bash.files, bash.files_count, sizeof(BASH_File_t), hash_djb2(file_name));
+  if(idx >= 0) return bash.files[idx].file;
   #if(LOG_COLORS)
     LOG_Warning("File " ANSI_ORANGE "%s" ANSI_END " not exist", (char *)file_name);
   #else
@@ -146,11 +205,46 @@ static FILE_t *BASH_FindFile(char *file_name)
   return NULL;
 }
 
+/**
+ * @brief Plik dodany do systemu BASH o podanym indeksie (kolejność wg hasha nazwy).
+ * @param index Indeks pliku.
+ * @return Wskaźnik do pliku lub `NULL`, gdy indeks jest poza zakresem.
+ */
+FILE_t *BASH_FileByIndex(uint16_t index)
+{
+  return index < bash.files_count ? bash.files[index].file : NULL;
+}
+
+/**
+ * @brief Plik dodany do systemu BASH o podanym hashu nazwy (`hash_djb2_ci`).
+ * @param hash Hash nazwy pliku.
+ * @return Wskaźnik do pliku lub `NULL`, gdy plik nie istnieje.
+ */
+FILE_t *BASH_FileByHash(uint32_t hash)
+{
+  int32_t idx = BASH_Search(bash.files, bash.files_count, sizeof(BASH_File_t), hash);
+  return idx >= 0 ? bash.files[idx].file : NULL;
+}
+
 static void BASH_AccessDenied(FILE_t *file)
 {
   LOG_Warning("File %s access denied", (char *)file->name);
 }
 
+#if(STREAM_FRAME)
+static void BASH_Transfer(FRAME_Status_e status)
+{
+  switch(status) {
+    case FRAME_Status_Ok:
+      LOG_Bash("File %s transfer started chunk:%u", bash.file_active->name, FRAME_CHUNK_SIZE);
+      break;
+    case FRAME_Status_Access: BASH_AccessDenied(bash.file_active); break;
+    case FRAME_Status_Range: LOG_Warning("File %s size exceeded (max:%u)", bash.file_active->name, bash.file_active->limit); break;
+    default: LOG_Warning("File transfer already in progress");
+  }
+}
+#endif
+
 static void BASH_File(char **argv, uint16_t argc, STREAM_t *stream)
 {
   if(!bash.files_count) {
@@ -163,7 +257,7 @@ static void BASH_File(char **argv, uint16_t argc, STREAM_t *stream)
       BASH_Argc(2);
       const char *file_names[bash.files_count];
       for(uint16_t i = 0; i < bash.files_count; i++) {
-        file_names[i] = bash.files[i]->name;
+        file_names[i] = bash.files[i].file->name;
       }
       #if(LOG_COLORS)
         LOG_Bash("File list: " ANSI_CREAM "%a %s" ANSI_END, bash.files_count, file_names);
@@ -306,6 +400,48 @@ static void BASH_File(char **argv, uint16_t argc, STREAM_t *stream)
       }
       break;
     }
+    #if(STREAM_FRAME)
+    case HASH_Upload: { // FILE upload <size:uint16> <window:uint8>?
+      BASH_Argc(3, 4);
+      if(!str_is_u16(argv[2])) {
+        LOG_ErrorParse(argv[2], "uint16_t");
+        BASH_ArgvExit(2);
+      }
+      uint16_t size = str_to_int(argv[2]);
+      uint16_t window = 0;
+      if(argc == 4) {
+        if(!str_is_u16(argv[3])) {
+          LOG_ErrorParse(argv[3], "uint16_t");
+          BASH_ArgvExit(3);
+        }
+        window = str_to_int(argv[3]);
+      }
+      BASH_Transfer(FRAME_Upload(stream, bash.file_active, size, window > 32 ? 32 : window, bash.flash_autosave));
+      break;
+    }
+    case HASH_Download: { // FILE download <window:uint8>?
+      BASH_Argc(2, 3);
+      uint16_t window = 0;
+      if(argc == 3) {
+        if(!str_is_u16(argv[2])) {
+          LOG_ErrorParse(argv[2], "uint16_t");
+          BASH_ArgvExit(2);
+        }
+        window = str_to_int(argv[2]);
+      }
+      BASH_Transfer(FRAME_Download(stream, bash.file_active, window > 32 ? 32 : window));
+      break;
+    }
+    case HASH_Transfer: { // FILE transfer {stop}?
+      BASH_Argc(2, 3);
+      if(argc == 3) {
+        if(hash_djb2(argv[2]) != HASH_Stop) BASH_ArgvExit(2);
+        FRAME_Abort();
+      }
+      else FRAME_TransferInfo();
+      break;
+    }
+    #endif
     case HASH_Print: { // FILE print {int8|uint8|int16|uint16|int32|uint32|struce} <limit:uint16>? <offset:uint16>?
       LOG_Bash("%02a %d", 50, bash.file_active->buffer);
       break;
@@ -525,6 +661,48 @@ static void BASH_Power(char **argv, uint16_t argc)
   }
 }
 
+//------------------------------------------------------------------------------------------------- Log
+
+static const char *const log_level_names[] = { "dbg", "inf", "wrn", "err", "crt", "pnc", "nil" };
+
+static LOG_Level_e LOG_StrLevel(const char *str)
+{
+  switch(hash_djb2(str)) {
+    case LOG_Hash_Dbg: case LOG_Hash_Debug: case HASH_0: return LOG_Level_Debug;
+    case LOG_Hash_Inf: case LOG_Hash_Info: case HASH_1: return LOG_Level_Info;
+    case LOG_Hash_Wrn: case LOG_Hash_Warning: case HASH_2: return LOG_Level_Warning;
+    case LOG_Hash_Err: case LOG_Hash_Error: case HASH_3: return LOG_Level_Error;
+    case LOG_Hash_Crt: case LOG_Hash_Critical: case HASH_4: return LOG_Level_Critical;
+    case LOG_Hash_Pnc: case LOG_Hash_Panic: case HASH_5: return LOG_Level_Panic;
+    case LOG_Hash_Nil: case LOG_Hash_None: case LOG_Hash_Off: case HASH_6: return LOG_Level_None;
+    default: return (LOG_Level_e)0xFF;
+  }
+}
+
+static void BASH_Log(char **argv, uint16_t argc)
+{
+  BASH_Argc(1, 3);
+  if(argc == 1) { // LOG
+    for(uint8_t i = 0; i < LogModules.count; i++) {
+      LOG_Bash("LOG %s %s", LogModules.name[i], log_level_names[LogModules.level[i]]);
+    }
+    return;
+  }
+  bool all = hash_djb2(argv[1]) == HASH_All;
+  uint8_t mod = all ? LOG_MODULE_MAIN : LOG_FindModule(argv[1]);
+  if(mod == LOG_MODULE_NONE) BASH_ArgvExit(1);
+  if(argc == 3) { // LOG {<module:str>|all} <level:str>
+    LOG_Level_e lvl = LOG_StrLevel(argv[2]);
+    if(lvl > LOG_Level_None) BASH_ArgvExit(2);
+    if(all) {
+      for(uint8_t i = 0; i < LogModules.count; i++) LOG_SetLevel(i, lvl);
+    }
+    else LOG_SetLevel(mod, lvl);
+  }
+  // LOG <module:str>
+  LOG_Bash("LOG %s %s", all ? "all" : LogModules.name[mod], log_level_names[LogModules.level[mod]]);
+}
+
 //------------------------------------------------------------------------------------------------- Addr
 
 #if(STREAM_ADDRESS)
@@ -605,58 +783,74 @@ static void BASH_Trig(char **argv, uint16_t argc)
 
 //------------------------------------------------------------------------------------------------- Loop
 
+/**
+ * @brief Wykonuje komendę (wbudowaną lub dodaną przez użytkownika) z podanymi argumentami.
+ * @param stream Strumień, z którego pochodzi komenda.
+ * @param argv Argumenty komendy, `argv[0]` to nazwa komendy.
+ * @param argc Ilość argumentów.
+ * @return `true` jeśli komenda została obsłużona, `false` dla nieznanej komendy.
+ */
+bool BASH_Exec(STREAM_t *stream, char **argv, uint16_t argc)
+{
+  uint32_t argv0_hash = hash_djb2(argv[0]);
+  switch(argv0_hash) {
+    case HASH_Ping: BASH_Ping(argv, argc); break;
+    case HASH_Trig: BASH_Trig(argv, argc); break;
+    case HASH_File: BASH_File(argv, argc, stream); break;
+    case HASH_Uid: BASH_Uid(argv, argc); break;
+    case HASH_Log: BASH_Log(argv, argc); break;
+    case HASH_Power: case HASH_Pwr: BASH_Power(argv, argc); break;
+    #ifdef RTC_H_
+      case HASH_Rtc: BASH_Rtc(argv, argc); break;
+      case HASH_Alarm: BASH_Alarm(argv, argc); break;
+    #endif
+    #if(STREAM_ADDRESS)
+      case HASH_Addr: break;
+    #endif
+    default: {
+      int32_t idx = BASH_Search(bash.callbacks, bash.callbacks_count, sizeof(BASH_Callback_t), argv0_hash);
+      if(idx >= 0) {
+        bash.callbacks[idx].callback(argv, argc);
+        return true;
+      }
+      if(bash.callback_default) {
+        bash.callback_default(argv, argc);
+        return true;
+      }
+      #if(LOG_COLORS)
+        LOG_Warning("Command " ANSI_ORANGE "%s" ANSI_END " not found", argv[0]);
+      #else
+        LOG_Warning("Command '%s' not found", argv[0]);
+      #endif
+      return false;
+    }
+  }
+  return true;
+}
+
 /**
  * @brief Obsługuje komendy odczytane ze strumienia w systemie BASH.
- * Obsługuje wbudowane komendy oraz te dodane przez użytkownika.
+ * Obsługuje wbudowane komendy oraz te dodane przez użytkownika,
+ * a przy `STREAM_FRAME` także ramki binarne (`FRAME_Handle`).
  * @param stream Strumień wejściowy (np. UART) z komendami lub danymi.
  * @return `true` jeśli komenda została obsłużona, `false` w przypadku błędu lub nieznanej komendy.
  */
 bool BASH_Loop(STREAM_t *stream)
 {
-  char **argv = NULL;
-  uint16_t argc = STREAM_Read(stream, &argv);
-  if(argc) {
-    if(stream->data_mode) BASH_Data((uint8_t *)argv[0], argc, stream);
-    else {
-      uint32_t argv0_hash = hash_djb2(argv[0]);
-      switch(argv0_hash) {
-        case HASH_Ping: BASH_Ping(argv, argc); break;
-        case HASH_Trig: BASH_Trig(argv, argc); break;
-        case HASH_File: BASH_File(argv, argc, stream); break;
-        case HASH_Uid: BASH_Uid(argv, argc); break;
-        case HASH_Power: case HASH_Pwr: BASH_Power(argv, argc); break;
-        #ifdef RTC_H_
-          case HASH_Rtc: BASH_Rtc(argv, argc); break;
-          case HASH_Alarm: BASH_Alarm(argv, argc); break;
-        #endif
-        #if(STREAM_ADDRESS)
-          case HASH_Addr: break;
-        #endif
-        default: {
-          for(uint8_t i = 0; i < bash.callbacks_count; i++) {
-            if(argv0_hash == bash.callbacks_hash[i]) {
-              bash.callbacks[i](argv, argc);
-              return true;
-            }
-          }
-          if(bash.callback_default) {
-            bash.callback_default(argv, argc);
-            return true;
-          }
-          else {
-            #if(LOG_COLORS)
-              LOG_Warning("Command " ANSI_ORANGE "%s" ANSI_END " not found", argv[0]);
-            #else
-              LOG_Warning("Command '%s' not found", argv[0]);
-            #endif
-            return false;
-          }
-        }
-      }
-    }
+  char *argv[BASH_ARGC_LIMIT];
+  uint16_t argc = STREAM_Read(stream, argv, BASH_ARGC_LIMIT);
+  #if(STREAM_FRAME)
+    FRAME_Loop(stream);
+  #endif
+  if(!argc) return false;
+  #if(STREAM_FRAME)
+    if(stream->frame) return FRAME_Handle(stream, (uint8_t *)argv[0], argc);
+  #endif
+  if(stream->data_mode) {
+    BASH_Data((uint8_t *)argv[0], argc, stream);
     return true;
   }
-  return false;
+  return BASH_Exec(stream, argv, argc);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -7,6 +7,7 @@
 
 //-------------------------------------------------------------------------------------------------
 
+// Initial capacity of file and command tables, both grow on heap when full
 #ifndef BASH_FILE_LIMIT
   #define BASH_FILE_LIMIT 8
 #endif
@@ -15,12 +16,19 @@
   #define BASH_CALLBACK_LIMIT 16
 #endif
 
+// Max number of command arguments (including command name), further are ignored
+#ifndef BASH_ARGC_LIMIT
+  #define BASH_ARGC_LIMIT 16
+#endif
+
 #define BASH_ArgcCount(count) if(argc != (count)) { BASH_WrongArgc(argv[0], argc); return; }
 #define BASH_ArgcMinMax(min, max) if(argc < (min) || argc > (max)) { BASH_WrongArgc(argv[0], argc); return; }
 #define BASH_ArgcGet(_1, _2, NAME, ...) NAME
 #define BASH_Argc(...) BASH_ArgcGet(__VA_ARGS__, BASH_ArgcMinMax, BASH_ArgcCount)(__VA_ARGS__)
 #define BASH_ArgvExit(nbr) { BASH_WrongArgv(argv[0], argv[nbr], nbr); return; }
 
+// Values of `*_Hash_*` and `HASH_*` enums are `hash_djb2` of lowercase name,
+// generated by `hash-gen.py` (add entry with `0` value and run the script)
 typedef enum {
   HASH_Ping = 2090616627,
   HASH_Trig = 2090770011,
@@ -69,6 +77,11 @@ typedef enum {
   HASH_Burst = 254705173,
   HASH_Duty = 2090198667,
   HASH_Fill = 2090257196,
+  HASH_Upload = 552758474,
+  HASH_Download = 1132745181,
+  HASH_Transfer = 3141699914,
+  HASH_Log = 193498375,
+  HASH_All = 193486302,
   HASH_0 = 177621,
   HASH_1 = 177622,
   HASH_2 = 177623,
@@ -81,6 +94,24 @@ typedef enum {
   HASH_9 = 177630
 } HASH_e;
 
+typedef enum {
+  LOG_Hash_Dbg = 193489234,
+  LOG_Hash_Debug = 256484652,
+  LOG_Hash_Inf = 193495074,
+  LOG_Hash_Info = 2090370257,
+  LOG_Hash_Wrn = 193510460,
+  LOG_Hash_Warning = 3064154235,
+  LOG_Hash_Err = 193490862,
+  LOG_Hash_Error = 258154991,
+  LOG_Hash_Crt = 193488686,
+  LOG_Hash_Critical = 502510928,
+  LOG_Hash_Pnc = 193502694,
+  LOG_Hash_Panic = 270584624,
+  LOG_Hash_Nil = 193500360,
+  LOG_Hash_None = 2090551285,
+  LOG_Hash_Off = 193501344
+} LOG_Hash_e;
+
 #ifdef RTC_H_
 typedef enum {
   RTC_Hash_Everyday = 552618222,
@@ -106,7 +137,7 @@ typedef enum {
   PWR_Hash_Stop = 2090736459,
   PWR_Hash_Stop0 = 274826459,
   PWR_Hash_Stop1 = 274826460,
-  PWR_Hash_StandbySram = 950227578,
+  PWR_Hash_StandbySram = 950227578, // "standby-sram"
   PWR_Hash_Standbysram = 1332813965,
   PWR_Hash_Standby = 2916655642,
   PWR_Hash_Shutdown = 4232446817,
@@ -117,6 +148,9 @@ void BASH_AddCallback(void (*callback)(char **, uint16_t), char *argv0);
 void BASH_FlashAutosave(bool autosave);
 void BASH_WrongArgc(char *cmd, uint16_t argc);
 void BASH_WrongArgv(char *cmd, char *argv, uint16_t pos);
+FILE_t *BASH_FileByIndex(uint16_t index);
+FILE_t *BASH_FileByHash(uint32_t hash);
+bool BASH_Exec(STREAM_t *stream, char **argv, uint16_t argc);
 bool BASH_Loop(STREAM_t *stream);
 
 uint16_t TRIG_Event(void);
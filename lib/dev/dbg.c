@@ -1,22 +1,34 @@
 #include "dbg.h"
 #include "bash.h"
 #include "log.h"
+#if(STREAM_FRAME)
+  #include "frame.h"
+#endif
 
 //------------------------------------------------------------------------------------------------- Basic
 
 static uint8_t dbg_buffer_rx[DBG_RX_SIZE];
-static uint8_t dbg_buffer_tx[DBG_TX_SIZE];
+#if(DBG_TX_RING)
+  static uint8_t dbg_buffer_tx[3 * DBG_TX_SIZE];
+#else
+  static uint8_t dbg_buffer_tx[2 * DBG_TX_SIZE];
+#endif
 
 static BUFF_t dbg_buff = {
   .memory = dbg_buffer_rx,
   .size = DBG_RX_SIZE,
-  .console_mode = true
+  .console_mode = true,
+  .frames = STREAM_FRAME
 };
 
 static FILE_t dbg_file = {
   .name = "debug",
   .buffer = dbg_buffer_tx,
-  .limit = DBG_TX_SIZE
+  #if(DBG_TX_RING)
+    .limit = 2 * DBG_TX_SIZE
+  #else
+    .limit = DBG_TX_SIZE
+  #endif
 };
 
 UART_t *DbgUart;
@@ -37,11 +49,23 @@ void DBG_SwitchMode(bool data_mode)
   }
 }
 
+#if(STREAM_FRAME && FRAME_SIZE + FRAME_SIZE / 254 + 4 > DBG_LINE_SIZE)
+  // Whole encoded frame: leading `0x00`, COBS overhead, delimiter and `0` terminator
+  #define DBG_LINE (FRAME_SIZE + FRAME_SIZE / 254 + 4)
+#else
+  #define DBG_LINE DBG_LINE_SIZE
+#endif
+
+static char dbg_line[DBG_LINE];
+
 STREAM_t dbg_stream = {
   .name = "debug",
   .modify = STREAM_Modify_Lowercase,
   .Size = DBG_Size,
   .Read = DBG_ReadString,
+  .ReadTo = DBG_Read,
+  .line = dbg_line,
+  .line_size = DBG_LINE,
   .SwitchMode = DBG_SwitchMode
 };
 
@@ -96,6 +120,50 @@ void DBG_Echo(void)
 }
 #endif
 
+/**
+ * @brief Hand filled part of `dbg_file` to DMA and give producers free buffer space.
+ *   Data is sent directly from file buffer, only pointers are swapped in critical section.
+ *   Must be called when UART is free (previous transfer completed).
+ * @return `true` if transfer was started.
+ */
+static bool DBG_Flush(void)
+{
+  if(!dbg_file.size) {
+    // Nothing in flight: whole space is free again
+    dbg_file.buffer = dbg_buffer_tx;
+    #if(DBG_TX_RING)
+      dbg_file.limit = 2 * DBG_TX_SIZE;
+    #endif
+  }
+  #if(LOG_BINARY)
+    dbg_file.size += LOG_BinaryRead(&dbg_file.buffer[dbg_file.size], dbg_file.limit - dbg_file.size);
+  #endif
+  if(!dbg_file.size) return false;
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  uint8_t *data = dbg_file.buffer;
+  uint16_t size = dbg_file.size;
+  #if(DBG_TX_RING)
+    // Segment starting in first part ends at `2 * DBG_TX_SIZE` at most, so sent data always
+    // leaves at least `DBG_TX_SIZE` free after it, or before it (previous transfer is finished)
+    uint16_t end = data - dbg_buffer_tx + size;
+    if(end <= 2 * DBG_TX_SIZE) {
+      dbg_file.buffer = data + size;
+      dbg_file.limit = (end < DBG_TX_SIZE ? 2 : 3) * DBG_TX_SIZE - end;
+    }
+    else {
+      dbg_file.buffer = dbg_buffer_tx;
+      dbg_file.limit = data - dbg_buffer_tx;
+    }
+  #else
+    dbg_file.buffer = data == dbg_buffer_tx ? &dbg_buffer_tx[DBG_TX_SIZE] : dbg_buffer_tx;
+  #endif
+  dbg_file.size = 0;
+  __set_PRIMASK(primask);
+  UART_Send(DbgUart, data, size);
+  return true;
+}
+
 void DBG_Loop(void)
 {
   while(1) {
@@ -105,13 +173,7 @@ void DBG_Loop(void)
     BASH_Loop(&dbg_stream);
     if(UART_IsFree(DbgUart)) {
       heap_clear();
-      if(DbgFile->size) {
-        uint8_t *buffer = (uint8_t *)heap_new(DbgFile->size);
-        memcpy(buffer, DbgFile->buffer, DbgFile->size);
-        UART_Send(DbgUart, buffer, DbgFile->size);
-        FILE_Clear(DbgFile);
-      }
-      else if(DbgReset && UART_SendCompleted(DbgUart)) PWR_Reset();
+      if(!DBG_Flush() && DbgReset && UART_SendCompleted(DbgUart)) PWR_Reset();
     }
     let();
   }
@@ -15,10 +15,22 @@
   #define DBG_RX_SIZE 2048
 #endif
 
+// Size of one TX buffer, two of them are used (`DbgFile` fills one, DMA sends the other)
 #ifndef DBG_TX_SIZE
   #define DBG_TX_SIZE 2048
 #endif
 
+// Use TX ring of three `DBG_TX_SIZE` parts: `DbgFile` gets from `DBG_TX_SIZE` up to twice that
+#ifndef DBG_TX_RING
+  #define DBG_TX_RING 0
+#endif
+
+// Command line buffer, shorter messages are read without heap allocation
+// (with `STREAM_FRAME` it is enlarged to fit whole frame of `FRAME_SIZE`)
+#ifndef DBG_LINE_SIZE
+  #define DBG_LINE_SIZE 128
+#endif
+
 #ifndef DBG_DATAMODE_TIMEOUT
   #define DBG_DATAMODE_TIMEOUT 200
 #endif
@@ -0,0 +1,543 @@
+#include "frame.h"
+
+//------------------------------------------------------------------------------------------------- COBS
+
+/**
+ * @brief Encode data with COBS (Consistent Overhead Byte Stuffing), result contains no `0x00`.
+ * @param src Source data.
+ * @param size Size of source data.
+ * @param dst Destination buffer, at least `size + size / 254 + 1` bytes.
+ * @return Size of encoded data.
+ */
+uint16_t cobs_encode(const uint8_t *src, uint16_t size, uint8_t *dst)
+{
+  uint16_t code_pos = 0, write = 1;
+  uint8_t code = 1;
+  for(uint16_t i = 0; i < size; i++) {
+    if(src[i]) {
+      dst[write++] = src[i];
+      code++;
+    }
+    if(!src[i] || code == 0xFF) {
+      dst[code_pos] = code;
+      code_pos = write++;
+      code = 1;
+    }
+  }
+  dst[code_pos] = code;
+  return write;
+}
+
+/**
+ * @brief Decode COBS data in place.
+ * @param data Encoded data (without `0x00` delimiters), overwritten with decoded data.
+ * @param size Size of encoded data.
+ * @return Size of decoded data, `0` if encoding is broken.
+ */
+uint16_t cobs_decode(uint8_t *data, uint16_t size)
+{
+  uint16_t read = 0, write = 0;
+  while(read < size) {
+    uint8_t code = data[read++];
+    if(!code || read + code - 1 > size) return 0;
+    for(uint8_t i = 1; i < code; i++) {
+      if(!data[read]) return 0;
+      data[write++] = data[read++];
+    }
+    if(code != 0xFF && read < size) data[write++] = 0x00;
+  }
+  return write;
+}
+
+//------------------------------------------------------------------------------------------------- Payload
+
+static uint8_t frame_reply[FRAME_SIZE];
+
+/**
+ * @brief State of windowed file transfer (one at a time).
+ *   Upload: `mask` marks received chunks from `base`, data is written straight into file buffer.
+ *   Download: `mask` marks acknowledged chunks, `pending` chunks to (re)send,
+ *   `resent` holes already resent since last timeout, `next` first chunk never sent.
+ *   `resend` counts resent chunks (download) or duplicates received (upload).
+ */
+static struct {
+  STREAM_t *stream;
+  FILE_t *file;
+  bool active;
+  bool complete;
+  bool download;
+  bool autosave;
+  uint8_t window;
+  uint8_t retries;
+  uint16_t size;
+  uint16_t count;
+  uint16_t base;
+  uint16_t next;
+  uint32_t mask;
+  uint32_t pending;
+  uint32_t resent;
+  uint16_t resend;
+  uint64_t start;
+  uint64_t deadline;
+  uint32_t time;
+} frame_transfer;
+
+static inline uint16_t FRAME_U16(const uint8_t *data)
+{
+  return (uint16_t)data[0] | ((uint16_t)data[1] << 8);
+}
+
+static inline uint32_t FRAME_U32(const uint8_t *data)
+{
+  return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+static inline uint8_t *FRAME_PutU16(uint8_t *data, uint16_t value)
+{
+  *data++ = (uint8_t)value;
+  *data++ = (uint8_t)(value >> 8);
+  return data;
+}
+
+static inline uint8_t *FRAME_PutU32(uint8_t *data, uint32_t value)
+{
+  data = FRAME_PutU16(data, (uint16_t)value);
+  return FRAME_PutU16(data, (uint16_t)(value >> 16));
+}
+
+static inline uint8_t FRAME_Flags(FILE_t *file)
+{
+  return (file->lock ? FRAME_Flag_Lock : 0) | (file->flash_page ? FRAME_Flag_Flash : 0);
+}
+
+//------------------------------------------------------------------------------------------------- Run
+
+static FRAME_Status_e FRAME_Exec(STREAM_t *stream, char *line, uint8_t *out, uint16_t *out_size)
+{
+  char *argv[BASH_ARGC_LIMIT];
+  const char *map = NULL;
+  if(stream->modify == STREAM_Modify_Lowercase) map = LowerCase;
+  else if(stream->modify == STREAM_Modify_Uppercase) map = UpperCase;
+  uint16_t argc = str_tokenize(line, argv, BASH_ARGC_LIMIT, map);
+  if(!argc) return FRAME_Status_Args;
+  // Text output of command (`LOG_Bash`, warnings) becomes reply payload
+  FILE_t capture = { .name = "frame", .buffer = out, .limit = *out_size };
+  FILE_t *previous = DbgFile;
+  DBG_SetFile(&capture);
+  bool found = BASH_Exec(stream, argv, argc);
+  DBG_SetFile(previous);
+  *out_size = capture.size;
+  return found ? FRAME_Status_Ok : FRAME_Status_Command;
+}
+
+static FRAME_Status_e FRAME_FileList(uint8_t *out, uint16_t *out_size)
+{
+  uint8_t *end = out + *out_size;
+  uint8_t *ptr = out + 1;
+  uint8_t count = 0;
+  FILE_t *file;
+  while(count < 0xFF && (file = BASH_FileByIndex(count))) {
+    uint8_t name_len = (uint8_t)strlen(file->name);
+    if(ptr + 10 + name_len > end) break;
+    ptr = FRAME_PutU32(ptr, hash_djb2_ci(file->name));
+    ptr = FRAME_PutU16(ptr, file->size);
+    ptr = FRAME_PutU16(ptr, file->limit);
+    *ptr++ = FRAME_Flags(file);
+    *ptr++ = name_len;
+    memcpy(ptr, file->name, name_len);
+    ptr += name_len;
+    count++;
+  }
+  out[0] = count;
+  *out_size = ptr - out;
+  return FRAME_Status_Ok;
+}
+
+static FRAME_Status_e FRAME_File(STREAM_t *stream, uint8_t op, uint8_t *arg, uint16_t arg_size, uint8_t *out, uint16_t *out_size)
+{
+  uint16_t capacity = *out_size;
+  *out_size = 0;
+  if(arg_size < 4) return FRAME_Status_Args;
+  FILE_t *file = BASH_FileByHash(FRAME_U32(arg));
+  if(!file) return FRAME_Status_File;
+  arg += 4;
+  arg_size -= 4;
+  switch(op) {
+    case FRAME_Op_FileInfo: {
+      if(arg_size) return FRAME_Status_Args;
+      uint8_t *ptr = FRAME_PutU16(out, file->size);
+      ptr = FRAME_PutU16(ptr, file->limit);
+      *ptr++ = FRAME_Flags(file);
+      *ptr++ = file->flash_page;
+      *out_size = ptr - out;
+      return FRAME_Status_Ok;
+    }
+    case FRAME_Op_FileRead: {
+      if(arg_size != 4) return FRAME_Status_Args;
+      uint16_t offset = FRAME_U16(arg);
+      uint16_t length = FRAME_U16(arg + 2);
+      if(offset > file->size) return FRAME_Status_Range;
+      if(length > file->size - offset) length = file->size - offset;
+      if(length > capacity) length = capacity;
+      memcpy(out, &file->buffer[offset], length);
+      *out_size = length;
+      return FRAME_Status_Ok;
+    }
+    case FRAME_Op_FileClear: {
+      if(arg_size) return FRAME_Status_Args;
+      return FILE_Clear(file) ? FRAME_Status_Access : FRAME_Status_Ok;
+    }
+    case FRAME_Op_FileAppend: {
+      if(file->lock) return FRAME_Status_Access;
+      if(file->size + arg_size > file->limit) return FRAME_Status_Range;
+      FILE_Append(file, arg, arg_size);
+      return FRAME_Status_Ok;
+    }
+    case FRAME_Op_FileFlash: {
+      if(arg_size != 1) return FRAME_Status_Args;
+      status_t status = *arg ? FILE_Flash_Save(file) : FILE_Flash_Load(file);
+      return status ? FRAME_Status_Flash : FRAME_Status_Ok;
+    }
+    case FRAME_Op_FileMutex: {
+      if(arg_size != 1) return FRAME_Status_Args;
+      if(frame_transfer.active && frame_transfer.file == file) return FRAME_Status_Transfer;
+      file->lock = *arg ? true : false;
+      return FRAME_Status_Ok;
+    }
+    case FRAME_Op_Upload: {
+      if(arg_size != 3) return FRAME_Status_Args;
+      FRAME_Status_e status = FRAME_Upload(stream, file, FRAME_U16(arg), arg[2], false);
+      if(status) return status;
+      uint8_t *ptr = FRAME_PutU16(out, FRAME_CHUNK_SIZE);
+      *ptr++ = frame_transfer.window;
+      *out_size = ptr - out;
+      return FRAME_Status_Ok;
+    }
+    case FRAME_Op_Download: {
+      if(arg_size != 1) return FRAME_Status_Args;
+      FRAME_Status_e status = FRAME_Download(stream, file, arg[0]);
+      if(status) return status;
+      uint8_t *ptr = FRAME_PutU16(out, frame_transfer.size);
+      ptr = FRAME_PutU16(ptr, FRAME_CHUNK_SIZE);
+      *ptr++ = frame_transfer.window;
+      *out_size = ptr - out;
+      return FRAME_Status_Ok;
+    }
+    default: return FRAME_Status_Opcode;
+  }
+}
+
+//------------------------------------------------------------------------------------------------- Send
+
+/**
+ * @brief Append reply from `frame_reply` with CRC to output file as `0x00 <COBS> 0x00`.
+ * @return `true` if reply fits in output file.
+ */
+static bool FRAME_Send(FILE_t *file, const CRC_t *crc, uint16_t size)
+{
+  size = CRC_Append(crc, frame_reply, size);
+  if(file->lock || file->size + size + size / 254 + 3 > file->limit) return false;
+  uint8_t *dst = &file->buffer[file->size];
+  *dst++ = 0x00;
+  dst += cobs_encode(frame_reply, size, dst);
+  *dst++ = 0x00;
+  file->size = dst - file->buffer;
+  return true;
+}
+
+//------------------------------------------------------------------------------------------------- Transfer
+
+static const CRC_t *FRAME_Crc(STREAM_t *stream)
+{
+  #if(STREAM_CRC)
+    return stream->crc;
+  #else
+    (void)stream;
+    return &FRAME_CRC;
+  #endif
+}
+
+static inline uint32_t FRAME_Bits(uint16_t count)
+{
+  return count >= 32 ? 0xFFFFFFFF : (1u << count) - 1;
+}
+
+static inline uint16_t FRAME_ChunkLength(uint16_t seq)
+{
+  uint16_t rest = frame_transfer.size - seq * FRAME_CHUNK_SIZE;
+  return rest < FRAME_CHUNK_SIZE ? rest : FRAME_CHUNK_SIZE;
+}
+
+static void FRAME_Start(STREAM_t *stream, FILE_t *file, uint16_t size, uint8_t window, bool download)
+{
+  memset(&frame_transfer, 0, sizeof(frame_transfer));
+  frame_transfer.stream = stream;
+  frame_transfer.file = file;
+  frame_transfer.active = true;
+  frame_transfer.download = download;
+  frame_transfer.window = !window ? FRAME_WINDOW : window > 32 ? 32 : window;
+  frame_transfer.size = size;
+  frame_transfer.count = (size + FRAME_CHUNK_SIZE - 1) / FRAME_CHUNK_SIZE;
+  frame_transfer.start = tick_now();
+}
+
+static void FRAME_Finish(bool complete)
+{
+  FILE_t *file = frame_transfer.file;
+  frame_transfer.active = false;
+  frame_transfer.complete = complete;
+  frame_transfer.time = tick_diff(frame_transfer.start);
+  if(!frame_transfer.download) {
+    file->lock = false;
+    if(complete) {
+      file->size = frame_transfer.size;
+      if(frame_transfer.autosave) FILE_Flash_Save(file);
+    }
+  }
+  FRAME_TransferInfo();
+}
+
+/**
+ * @brief Start receiving file in chunks (`FRAME_Op_Chunk` requests).
+ *   File is cleared and locked until transfer ends, chunks are written directly into its buffer.
+ *   Transfer is aborted when no chunk comes for `FRAME_RETRY_LIMIT * FRAME_RETRY_TIMEOUT`.
+ * @param stream Stream carrying chunks.
+ * @param file Destination file.
+ * @param size Size of file data.
+ * @param window Chunks in flight, `0` for `FRAME_WINDOW`.
+ * @param autosave Save file to flash when transfer is complete.
+ * @return `FRAME_Status_Ok` if transfer started.
+ */
+FRAME_Status_e FRAME_Upload(STREAM_t *stream, FILE_t *file, uint16_t size, uint8_t window, bool autosave)
+{
+  if(frame_transfer.active) return FRAME_Status_Transfer;
+  if(size > file->limit) return FRAME_Status_Range;
+  if(FILE_Clear(file)) return FRAME_Status_Access;
+  file->lock = true;
+  FRAME_Start(stream, file, size, window, false);
+  frame_transfer.autosave = autosave;
+  frame_transfer.deadline = tick_keep(FRAME_RETRY_LIMIT * FRAME_RETRY_TIMEOUT);
+  if(!frame_transfer.count) FRAME_Finish(true);
+  return FRAME_Status_Ok;
+}
+
+/**
+ * @brief Start sending file in chunks (sent from `FRAME_Loop`, acknowledged by `FRAME_Op_Ack`).
+ * @param stream Stream to send chunks to.
+ * @param file Source file, its current size is sent.
+ * @param window Chunks in flight, `0` for `FRAME_WINDOW`.
+ * @return `FRAME_Status_Ok` if transfer started.
+ */
+FRAME_Status_e FRAME_Download(STREAM_t *stream, FILE_t *file, uint8_t window)
+{
+  if(frame_transfer.active) return FRAME_Status_Transfer;
+  FRAME_Start(stream, file, file->size, window, true);
+  if(!frame_transfer.count) FRAME_Finish(true);
+  return FRAME_Status_Ok;
+}
+
+/**
+ * @brief Abort transfer in progress.
+ */
+void FRAME_Abort(void)
+{
+  if(frame_transfer.active) FRAME_Finish(false);
+}
+
+/**
+ * @brief Print progress of current transfer or result (with throughput) of last one.
+ */
+void FRAME_TransferInfo(void)
+{
+  FILE_t *file = frame_transfer.file;
+  if(!file) {
+    LOG_Bash("File no transfer");
+    return;
+  }
+  const char *direction = frame_transfer.download ? "download" : "upload";
+  if(frame_transfer.active) {
+    uint32_t done = (uint32_t)frame_transfer.base * FRAME_CHUNK_SIZE;
+    if(done > frame_transfer.size) done = frame_transfer.size;
+    LOG_Bash("File %s %s %u/%uB window:%u resend:%u", file->name, direction, done,
+      frame_transfer.size, frame_transfer.window, frame_transfer.resend);
+  }
+  else if(frame_transfer.complete) {
+    uint32_t time = frame_transfer.time ? frame_transfer.time : 1;
+    LOG_Bash("File %s %s %uB %ums %uB/s resend:%u", file->name, direction, frame_transfer.size,
+      frame_transfer.time, (uint32_t)frame_transfer.size * 1000 / time, frame_transfer.resend);
+  }
+  else {
+    LOG_Warning("File %s %s aborted after %ums", file->name, direction, frame_transfer.time);
+  }
+}
+
+static bool FRAME_SendChunk(STREAM_t *stream, uint16_t seq)
+{
+  uint8_t *ptr = frame_reply;
+  #if(STREAM_ADDRESS)
+    *ptr++ = stream->address;
+  #endif
+  *ptr++ = 0;
+  *ptr++ = FRAME_Op_Chunk | FRAME_REPLY;
+  *ptr++ = FRAME_Status_Ok;
+  ptr = FRAME_PutU16(ptr, seq);
+  uint16_t length = FRAME_ChunkLength(seq);
+  memcpy(ptr, &frame_transfer.file->buffer[seq * FRAME_CHUNK_SIZE], length);
+  return FRAME_Send(DbgFile, FRAME_Crc(stream), ptr - frame_reply + length);
+}
+
+static FRAME_Status_e FRAME_Chunk(STREAM_t *stream, uint8_t *arg, uint16_t arg_size, uint8_t *out, uint16_t *out_size)
+{
+  *out_size = 0;
+  if(!frame_transfer.active || frame_transfer.download || frame_transfer.stream != stream) return FRAME_Status_Transfer;
+  if(arg_size < 2) return FRAME_Status_Args;
+  uint16_t seq = FRAME_U16(arg);
+  if(seq >= frame_transfer.count || seq >= frame_transfer.base + frame_transfer.window) return FRAME_Status_Range;
+  uint16_t length = FRAME_ChunkLength(seq);
+  if(arg_size - 2 != length) return FRAME_Status_Args;
+  frame_transfer.deadline = tick_keep(FRAME_RETRY_LIMIT * FRAME_RETRY_TIMEOUT);
+  uint32_t bit = seq >= frame_transfer.base ? 1u << (seq - frame_transfer.base) : 0;
+  if(bit && !(frame_transfer.mask & bit)) {
+    memcpy(&frame_transfer.file->buffer[seq * FRAME_CHUNK_SIZE], arg + 2, length);
+    frame_transfer.mask |= bit;
+    while(frame_transfer.mask & 1) {
+      frame_transfer.mask >>= 1;
+      frame_transfer.base++;
+    }
+  }
+  else frame_transfer.resend++;
+  uint8_t *ptr = FRAME_PutU16(out, frame_transfer.base);
+  ptr = FRAME_PutU32(ptr, frame_transfer.mask);
+  *out_size = ptr - out;
+  if(frame_transfer.base >= frame_transfer.count) FRAME_Finish(true);
+  return FRAME_Status_Ok;
+}
+
+static FRAME_Status_e FRAME_Ack(STREAM_t *stream, uint8_t *arg, uint16_t arg_size)
+{
+  if(!frame_transfer.active || !frame_transfer.download || frame_transfer.stream != stream) return FRAME_Status_Transfer;
+  if(arg_size != 6) return FRAME_Status_Args;
+  uint16_t base = FRAME_U16(arg);
+  uint32_t mask = FRAME_U32(arg + 2);
+  if(base < frame_transfer.base || base > frame_transfer.next) return FRAME_Status_Range; // Stale
+  uint16_t shift = base - frame_transfer.base;
+  mask &= FRAME_Bits(frame_transfer.next - base);
+  // Repeated acknowledgment keeps timeout running, otherwise a lost resend would never be retried
+  bool progress = shift || (mask & ~frame_transfer.mask);
+  frame_transfer.base = base;
+  frame_transfer.pending = shift < 32 ? frame_transfer.pending >> shift : 0;
+  frame_transfer.resent = shift < 32 ? frame_transfer.resent >> shift : 0;
+  frame_transfer.mask = mask;
+  frame_transfer.pending &= ~frame_transfer.mask;
+  if(progress) frame_transfer.retries = 0;
+  if(base >= frame_transfer.count) {
+    FRAME_Finish(true);
+    return FRAME_Status_Ok;
+  }
+  // Link keeps order, so holes below highest acknowledged chunk are lost: resend each once
+  uint32_t below = frame_transfer.mask;
+  below |= below >> 1;
+  below |= below >> 2;
+  below |= below >> 4;
+  below |= below >> 8;
+  below |= below >> 16;
+  uint32_t holes = (below >> 1) & ~frame_transfer.mask & ~frame_transfer.resent;
+  frame_transfer.pending |= holes;
+  frame_transfer.resent |= holes;
+  if(progress) frame_transfer.deadline = tick_keep(FRAME_RETRY_TIMEOUT);
+  return FRAME_Status_Ok;
+}
+
+/**
+ * @brief Run transfer timeouts and send download chunks while window and output space allow.
+ *   Called from `BASH_Loop` after `STREAM_Read`, so `DbgFile` is output of `stream`.
+ * @param stream Stream being served.
+ */
+void FRAME_Loop(STREAM_t *stream)
+{
+  if(!frame_transfer.active || frame_transfer.stream != stream) return;
+  if(tick_over(&frame_transfer.deadline)) {
+    if(!frame_transfer.download || ++frame_transfer.retries > FRAME_RETRY_LIMIT) {
+      FRAME_Finish(false);
+      return;
+    }
+    // No acknowledgment: resend all unacknowledged chunks
+    frame_transfer.pending = FRAME_Bits(frame_transfer.next - frame_transfer.base) & ~frame_transfer.mask;
+    frame_transfer.resent = frame_transfer.pending;
+  }
+  if(!frame_transfer.download) return;
+  for(uint8_t i = 0; frame_transfer.pending && i < 32; i++) {
+    uint32_t bit = 1u << i;
+    if(!(frame_transfer.pending & bit)) continue;
+    if(!FRAME_SendChunk(stream, frame_transfer.base + i)) return;
+    frame_transfer.pending &= ~bit;
+    frame_transfer.resend++;
+  }
+  while(frame_transfer.next < frame_transfer.count && frame_transfer.next - frame_transfer.base < frame_transfer.window) {
+    if(!FRAME_SendChunk(stream, frame_transfer.next)) break;
+    frame_transfer.next++;
+  }
+  if(!frame_transfer.deadline) frame_transfer.deadline = tick_keep(FRAME_RETRY_TIMEOUT);
+}
+
+//------------------------------------------------------------------------------------------------- Handle
+
+/**
+ * @brief Handle binary frame read by `STREAM_Read` and queue reply to stream output file.
+ * @param stream Stream the frame comes from.
+ * @param data COBS-encoded frame (decoded in place).
+ * @param size Size of encoded frame.
+ * @return `true` if frame was valid and reply was queued.
+ */
+bool FRAME_Handle(STREAM_t *stream, uint8_t *data, uint16_t size)
+{
+  const CRC_t *crc = FRAME_Crc(stream);
+  uint8_t crc_size = crc->width / 8;
+  size = cobs_decode(data, size);
+  if(size < STREAM_ADDRESS + 2 + crc_size || size > FRAME_SIZE) return false;
+  if(CRC_Error(crc, data, size)) return false;
+  size -= crc_size;
+  uint8_t *reply = frame_reply;
+  #if(STREAM_ADDRESS)
+    if(*data != stream->address) return false;
+    *reply++ = *data++;
+    size--;
+  #endif
+  uint8_t op = data[1];
+  uint8_t *arg = &data[2];
+  uint16_t arg_size = size - 2;
+  arg[arg_size] = '\0'; // In place of CRC, payload of `FRAME_Op_Exec` is string
+  *reply++ = data[0];
+  *reply++ = op | FRAME_REPLY;
+  uint8_t *status = reply++;
+  uint16_t reply_size = frame_reply + FRAME_SIZE - crc_size - reply;
+  FILE_t *output = DbgFile;
+  switch(op) {
+    case FRAME_Op_Ping: {
+      if(arg_size > reply_size) {
+        *status = FRAME_Status_Args;
+        reply_size = 0;
+        break;
+      }
+      memcpy(reply, arg, arg_size);
+      reply_size = arg_size;
+      *status = FRAME_Status_Ok;
+      break;
+    }
+    case FRAME_Op_Exec: *status = FRAME_Exec(stream, (char *)arg, reply, &reply_size); break;
+    case FRAME_Op_FileList: *status = FRAME_FileList(reply, &reply_size); break;
+    case FRAME_Op_FileInfo: case FRAME_Op_FileRead: case FRAME_Op_FileClear:
+    case FRAME_Op_FileAppend: case FRAME_Op_FileFlash: case FRAME_Op_FileMutex:
+    case FRAME_Op_Upload: case FRAME_Op_Download:
+      *status = FRAME_File(stream, op, arg, arg_size, reply, &reply_size);
+      break;
+    case FRAME_Op_Chunk: *status = FRAME_Chunk(stream, arg, arg_size, reply, &reply_size); break;
+    case FRAME_Op_Ack: return FRAME_Ack(stream, arg, arg_size) == FRAME_Status_Ok; // No reply
+    default:
+      *status = FRAME_Status_Opcode;
+      reply_size = 0;
+  }
+  return FRAME_Send(output, crc, reply - frame_reply + reply_size);
+}
+
+//-------------------------------------------------------------------------------------------------
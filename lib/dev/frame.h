@@ -0,0 +1,105 @@
+#ifndef FRAME_H_
+#define FRAME_H_
+
+#include "bash.h"
+#include "crc.h"
+#include "main.h"
+
+//-------------------------------------------------------------------------------------------------
+
+// Max size of decoded frame (address, id, opcode, payload and CRC)
+#ifndef FRAME_SIZE
+  #define FRAME_SIZE 256
+#endif
+
+// CRC of frames, used when stream has no own `crc` (`STREAM_CRC`)
+#ifndef FRAME_CRC
+  #define FRAME_CRC crc16_modbus
+#endif
+
+// Data bytes in one chunk of windowed file transfer (must fit in `FRAME_SIZE` with 8-byte header)
+#ifndef FRAME_CHUNK_SIZE
+  #define FRAME_CHUNK_SIZE 128
+#endif
+
+#if(FRAME_CHUNK_SIZE + 8 > FRAME_SIZE)
+  #error "FRAME_CHUNK_SIZE with 8-byte chunk header does not fit in FRAME_SIZE"
+#endif
+
+// Default number of chunks in flight, max 32
+#ifndef FRAME_WINDOW
+  #define FRAME_WINDOW 8
+#endif
+
+// Time without acknowledgment after which download resends unacknowledged chunks [ms]
+#ifndef FRAME_RETRY_TIMEOUT
+  #define FRAME_RETRY_TIMEOUT 500
+#endif
+
+// Timeouts in a row after which transfer is aborted
+#ifndef FRAME_RETRY_LIMIT
+  #define FRAME_RETRY_LIMIT 10
+#endif
+
+//-------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Binary command frame, sent on console stream as `0x00 <COBS data> 0x00`.
+ *   Request: `[address] id opcode payload crc`, reply: `[address] id opcode|0x80 status payload crc`.
+ *   Integers in payload are little-endian, files are selected by `hash_djb2_ci` of name (`u32`).
+ *   Reply carries `id` of request, so host may send several requests before reading replies.
+ *   Frames with bad CRC or COBS encoding are dropped without reply.
+ *   Windowed file transfer sends file in `FRAME_CHUNK_SIZE` chunks numbered by `seq`,
+ *   up to `window` chunks in flight. Receiver acknowledges with `base` (first missing chunk)
+ *   and `mask` (bit `i` set if chunk `base + i` was received), sender resends only the holes.
+ */
+typedef enum {
+  FRAME_Op_Ping = 0x00,       // payload → same payload
+  FRAME_Op_Exec = 0x01,       // command line → text output of command
+  FRAME_Op_FileList = 0x10,   // → count:u8 { hash:u32 size:u16 limit:u16 flags:u8 name_len:u8 name }...
+  FRAME_Op_FileInfo = 0x11,   // hash:u32 → size:u16 limit:u16 flags:u8 flash_page:u8
+  FRAME_Op_FileRead = 0x12,   // hash:u32 offset:u16 length:u16 → data
+  FRAME_Op_FileClear = 0x13,  // hash:u32 →
+  FRAME_Op_FileAppend = 0x14, // hash:u32 data →
+  FRAME_Op_FileFlash = 0x15,  // hash:u32 save:u8 →
+  FRAME_Op_FileMutex = 0x16,  // hash:u32 lock:u8 →
+  FRAME_Op_Upload = 0x20,     // hash:u32 size:u16 window:u8 → chunk:u16 window:u8
+  FRAME_Op_Download = 0x21,   // hash:u32 window:u8 → size:u16 chunk:u16 window:u8
+  FRAME_Op_Chunk = 0x22,      // seq:u16 data → base:u16 mask:u32 (upload), sent by device with id `0` (download)
+  FRAME_Op_Ack = 0x23,        // base:u16 mask:u32 (download, no reply)
+  FRAME_Op_Log = 0x30,        // binary log record (`LOG_BIN`), sent by device with id `0`
+} FRAME_Op_e;
+
+#define FRAME_REPLY 0x80
+
+typedef enum {
+  FRAME_Status_Ok = 0,
+  FRAME_Status_Opcode = 1,  // Unknown opcode
+  FRAME_Status_Args = 2,    // Wrong payload size
+  FRAME_Status_Command = 3, // Command not found (`FRAME_Op_Exec`)
+  FRAME_Status_File = 4,    // File not found
+  FRAME_Status_Access = 5,  // File locked
+  FRAME_Status_Range = 6,   // Offset or size out of file limit
+  FRAME_Status_Flash = 7,   // Flash save/load fault
+  FRAME_Status_Transfer = 8 // No matching transfer in progress or other transfer is busy
+} FRAME_Status_e;
+
+typedef enum {
+  FRAME_Flag_Lock = 0x01,
+  FRAME_Flag_Flash = 0x02
+} FRAME_Flag_e;
+
+//-------------------------------------------------------------------------------------------------
+
+uint16_t cobs_encode(const uint8_t *src, uint16_t size, uint8_t *dst);
+uint16_t cobs_decode(uint8_t *data, uint16_t size);
+
+bool FRAME_Handle(STREAM_t *stream, uint8_t *data, uint16_t size);
+FRAME_Status_e FRAME_Upload(STREAM_t *stream, FILE_t *file, uint16_t size, uint8_t window, bool autosave);
+FRAME_Status_e FRAME_Download(STREAM_t *stream, FILE_t *file, uint8_t window);
+void FRAME_Abort(void);
+void FRAME_Loop(STREAM_t *stream);
+void FRAME_TransferInfo(void);
+
+//-------------------------------------------------------------------------------------------------
+#endif
@@ -0,0 +1,288 @@
+#!/usr/bin/env python3
+"""
+Host client of binary frame protocol (`frame.h`, `STREAM_FRAME` mode) on debug port.
+Frames are sent as `0x00 <COBS data> 0x00`, data ends with CRC-16/MODBUS (low byte first).
+Text output of the port (logs, bash) between frames is printed to stderr.
+
+  python frame.py COM3 ping
+  python frame.py COM3 exec "rtc"
+  python frame.py COM3 list
+  python frame.py COM3 read cache_file out.bin
+  python frame.py COM3 write cache_file in.bin --flash
+  python frame.py COM3 upload cache_file in.bin --window 16
+  python frame.py COM3 download cache_file out.bin
+"""
+
+import argparse
+import struct
+import sys
+import time
+
+OP_PING, OP_EXEC = 0x00, 0x01
+OP_FILE_LIST, OP_FILE_INFO, OP_FILE_READ, OP_FILE_CLEAR = 0x10, 0x11, 0x12, 0x13
+OP_FILE_APPEND, OP_FILE_FLASH, OP_FILE_MUTEX = 0x14, 0x15, 0x16
+OP_UPLOAD, OP_DOWNLOAD, OP_CHUNK, OP_ACK = 0x20, 0x21, 0x22, 0x23
+OP_LOG = 0x30  # Binary log record sent by device, decoded by `log-decode.py`
+REPLY = 0x80
+STATUS = ["ok", "unknown opcode", "wrong arguments", "command not found", "file not found",
+  "file locked", "out of file range", "flash fault", "no transfer in progress"]
+STATUS_TRANSFER = 8
+FRAME_SIZE = 256
+
+def cobs_encode(data: bytes) -> bytes:
+  out, block = bytearray(), bytearray()
+  for byte in data:
+    if byte:
+      block.append(byte)
+    if not byte or len(block) == 254:
+      out += bytes([len(block) + 1]) + block
+      block = bytearray()
+  return bytes(out + bytes([len(block) + 1]) + block)
+
+def cobs_decode(data: bytes) -> bytes:
+  out, i = bytearray(), 0
+  while i < len(data):
+    code = data[i]
+    if not code or i + code > len(data):
+      raise ValueError("broken COBS")
+    out += data[i + 1:i + code]
+    i += code
+    if code != 0xFF and i < len(data):
+      out.append(0)
+  return bytes(out)
+
+def crc16_modbus(data: bytes) -> int:
+  crc = 0xFFFF
+  for byte in data:
+    crc ^= byte
+    for _ in range(8):
+      crc = (crc >> 1) ^ 0xA001 if crc & 1 else crc >> 1
+  return crc
+
+def hash_djb2(text: str) -> int:
+  """Same as `hash_djb2_ci` in `extstr.c` (file names are selected by this hash)."""
+  value = 5381
+  for char in text.lower().encode():
+    value = (value * 33 + char) & 0xFFFFFFFF
+  return value
+
+class FrameError(Exception):
+  pass
+
+class Client:
+  def __init__(self, port, address: int | None = None):
+    self.port = port
+    self.address = address
+    self.id = 0
+    self.text = bytearray()
+
+  def send(self, op: int, payload: bytes = b"") -> int:
+    """Sends request without waiting for reply, returns request ID."""
+    self.id = self.id % 0xFF + 1  # ID 0 is used by chunks sent from device
+    data = bytes([self.id, op]) + payload
+    if self.address is not None:
+      data = bytes([self.address]) + data
+    data += struct.pack("<H", crc16_modbus(data))
+    self.port.write(b"\0" + cobs_encode(data) + b"\0")
+    return self.id
+
+  def receive(self) -> tuple[int, int, int, bytes]:
+    """Reads next valid reply frame, returns (id, opcode, status, payload)."""
+    while True:
+      byte = self.port.read(1)
+      if not byte:
+        raise TimeoutError("no reply")
+      if byte != b"\0":
+        self.text += byte
+        if byte == b"\n":
+          sys.stderr.write(self.text.decode(errors="replace"))
+          self.text.clear()
+        continue
+      frame = bytearray()
+      while not frame or frame[-1]:
+        byte = self.port.read(1)
+        if not byte:
+          raise TimeoutError("frame not finished")
+        if byte == b"\0" and not frame:
+          continue
+        frame += byte
+      try:
+        data = cobs_decode(bytes(frame[:-1]))
+      except ValueError:
+        continue
+      if len(data) < 5 or crc16_modbus(data[:-2]) != struct.unpack("<H", data[-2:])[0]:
+        continue
+      data = data[:-2]
+      if self.address is not None:
+        if data[0] != self.address:
+          continue
+        data = data[1:]
+      return data[0], data[1] & ~REPLY, data[2], data[3:]
+
+  def request(self, op: int, payload: bytes = b"") -> bytes:
+    id = self.send(op, payload)
+    while True:
+      reply_id, reply_op, status, data = self.receive()
+      if reply_id != id or reply_op != op:
+        continue
+      if status:
+        raise FrameError(STATUS[status] if status < len(STATUS) else f"status {status}")
+      return data
+
+  def ping(self, payload: bytes = b"") -> bytes:
+    return self.request(OP_PING, payload)
+
+  def exec(self, line: str) -> str:
+    return self.request(OP_EXEC, line.encode()).decode(errors="replace")
+
+  def file_list(self) -> list[dict]:
+    data = self.request(OP_FILE_LIST)
+    files, pos = [], 1
+    for _ in range(data[0]):
+      hash, size, limit, flags, name_len = struct.unpack_from("<IHHBB", data, pos)
+      pos += 10
+      name = data[pos:pos + name_len].decode()
+      pos += name_len
+      files.append(dict(name=name, hash=hash, size=size, limit=limit, lock=bool(flags & 1), flash=bool(flags & 2)))
+    return files
+
+  def file_info(self, name: str) -> dict:
+    size, limit, flags, flash_page = struct.unpack("<HHBB", self.request(OP_FILE_INFO, struct.pack("<I", hash_djb2(name))))
+    return dict(name=name, size=size, limit=limit, lock=bool(flags & 1), flash=flash_page)
+
+  def file_read(self, name: str) -> bytes:
+    hash = hash_djb2(name)
+    size = self.file_info(name)["size"]
+    data = bytearray()
+    while len(data) < size:
+      chunk = self.request(OP_FILE_READ, struct.pack("<IHH", hash, len(data), size - len(data)))
+      if not chunk:
+        break
+      data += chunk
+    return bytes(data)
+
+  def file_write(self, name: str, data: bytes, flash: bool = False):
+    hash = struct.pack("<I", hash_djb2(name))
+    chunk_size = FRAME_SIZE - (2 + 4 + 2) - (self.address is not None)
+    self.request(OP_FILE_CLEAR, hash)
+    for pos in range(0, len(data), chunk_size):
+      self.request(OP_FILE_APPEND, hash + data[pos:pos + chunk_size])
+    if flash:
+      self.request(OP_FILE_FLASH, hash + b"\1")
+
+  def _chunk(self, data: bytes, chunk: int, seq: int):
+    self.send(OP_CHUNK, struct.pack("<H", seq) + data[seq * chunk:(seq + 1) * chunk])
+
+  def upload(self, name: str, data: bytes, window: int = 0) -> tuple[float, int]:
+    """Windowed upload to file, returns (seconds, resent chunks)."""
+    start = time.monotonic()
+    reply = self.request(OP_UPLOAD, struct.pack("<IHB", hash_djb2(name), len(data), window))
+    chunk, window = struct.unpack("<HB", reply)
+    count = -(-len(data) // chunk)
+    base = next = resend = 0
+    acked, resent = set(), set()
+    while base < count:
+      while next < count and next < base + window:
+        self._chunk(data, chunk, next)
+        next += 1
+      try:
+        _, op, status, payload = self.receive()
+      except TimeoutError:
+        # No acknowledgment: resend all unacknowledged chunks
+        resent = {seq for seq in range(base, next) if seq not in acked}
+        for seq in sorted(resent):
+          self._chunk(data, chunk, seq)
+        resend += len(resent)
+        continue
+      if op != OP_CHUNK:
+        continue
+      if status == STATUS_TRANSFER and next == count:
+        break  # Last acknowledgment was lost, device already finished
+      if status:
+        raise FrameError(STATUS[status] if status < len(STATUS) else f"status {status}")
+      ack_base, mask = struct.unpack("<HI", payload)
+      if ack_base < base:
+        continue
+      base = ack_base
+      acked = {base + i for i in range(32) if mask >> i & 1}
+      resent = {seq for seq in resent if seq >= base}
+      # Link keeps order, so holes below highest acknowledged chunk are lost
+      for seq in range(base, base + mask.bit_length() - 1):
+        if seq not in acked and seq not in resent:
+          self._chunk(data, chunk, seq)
+          resent.add(seq)
+          resend += 1
+    return time.monotonic() - start, resend
+
+  def _ack(self, base: int, chunks: dict):
+    mask = sum(1 << (seq - base) for seq in chunks if base <= seq < base + 32)
+    self.send(OP_ACK, struct.pack("<HI", base, mask))
+
+  def download(self, name: str, window: int = 0) -> bytes:
+    """Windowed download of file content."""
+    reply = self.request(OP_DOWNLOAD, struct.pack("<IB", hash_djb2(name), window))
+    size, chunk, window = struct.unpack("<HHB", reply)
+    count = -(-size // chunk)
+    chunks, base = {}, 0
+    while base < count:
+      try:
+        id, op, status, payload = self.receive()
+      except TimeoutError:
+        self._ack(base, chunks)
+        continue
+      if op != OP_CHUNK or id:
+        continue
+      seq, = struct.unpack_from("<H", payload)
+      if seq >= base:
+        chunks.setdefault(seq, payload[2:])
+      while base in chunks:
+        base += 1
+      self._ack(base, chunks)
+    self._ack(base, chunks)  # Second copy of final acknowledgment
+    return b"".join(chunks[seq] for seq in range(count))
+
+if __name__ == "__main__":
+  parser = argparse.ArgumentParser(description="OpenCPLC binary frame client")
+  parser.add_argument("port", help="Serial port (requires pyserial)")
+  parser.add_argument("command", choices=["ping", "exec", "list", "info", "read", "write", "upload", "download"])
+  parser.add_argument("args", nargs="*")
+  parser.add_argument("--baud", type=int, default=115200)
+  parser.add_argument("--address", type=int, help="Stream address (STREAM_ADDRESS)")
+  parser.add_argument("--flash", action="store_true", help="Save file to flash after write/upload")
+  parser.add_argument("--window", type=int, default=0, help="Chunks in flight (0: device default)")
+  args = parser.parse_args()
+  import serial
+  client = Client(serial.Serial(args.port, args.baud, timeout=1), args.address)
+  if args.command == "ping":
+    print(client.ping(" ".join(args.args).encode()).decode(errors="replace") or "pong")
+  elif args.command == "exec":
+    sys.stdout.write(client.exec(" ".join(args.args)))
+  elif args.command == "list":
+    for file in client.file_list():
+      print(f"{file['name']:16} {file['size']:5}/{file['limit']:<5}{' mutex' if file['lock'] else ''}{' flash' if file['flash'] else ''}")
+  elif args.command == "info":
+    print(client.file_info(args.args[0]))
+  elif args.command == "read":
+    data = client.file_read(args.args[0])
+    if len(args.args) > 1:
+      open(args.args[1], "wb").write(data)
+    else:
+      sys.stdout.buffer.write(data)
+  elif args.command == "write":
+    client.file_write(args.args[0], open(args.args[1], "rb").read(), args.flash)
+  elif args.command == "upload":
+    data = open(args.args[1], "rb").read()
+    seconds, resend = client.upload(args.args[0], data, args.window)
+    if args.flash:
+      client.request(OP_FILE_FLASH, struct.pack("<I", hash_djb2(args.args[0])) + b"\1")
+    print(f"{len(data)}B {seconds * 1000:.0f}ms {len(data) / max(seconds, 1e-3):.0f}B/s resend:{resend}")
+    sys.stdout.write(client.exec("file transfer"))
+  elif args.command == "download":
+    start = time.monotonic()
+    data = client.download(args.args[0], args.window)
+    seconds = time.monotonic() - start
+    if len(args.args) > 1:
+      open(args.args[1], "wb").write(data)
+    else:
+      sys.stdout.buffer.write(data)
+    print(f"{len(data)}B {seconds * 1000:.0f}ms {len(data) / max(seconds, 1e-3):.0f}B/s", file=sys.stderr)
@@ -0,0 +1,59 @@
+#!/usr/bin/env python3
+"""
+Generator of djb2 hash constants used in `switch(hash_djb2(argv[n]))` of bash commands.
+Every enum entry `<PREFIX>_Hash_<Name> = <value>,` or `HASH_<Name> = <value>,` gets value
+of `hash_djb2` computed from lowercase `<Name>`. Other word can be given in trailing comment:
+`PWR_Hash_StandbySram = 0, // "standby-sram"`. New entries can be written with `0` value.
+
+  python hash-gen.py              # update headers in lib/ and plc/
+  python hash-gen.py --check      # only verify (exit code 1 if any value is wrong)
+  python hash-gen.py app/cmd.h    # update selected headers
+"""
+
+import argparse
+import pathlib
+import re
+import sys
+
+ENTRY = re.compile(r'^(\s*)((?:[A-Z0-9]+_Hash|HASH)_(\w+))\s*=\s*(\d+)(\s*,?)(.*)$')
+WORD = re.compile(r'//\s*"([^"]*)"')
+
+def hash_djb2(text: str) -> int:
+  """Same as `hash_djb2` in `extstr.c`."""
+  value = 5381
+  for char in text.encode():
+    value = (value * 33 + char) & 0xFFFFFFFF
+  return value
+
+def update(path: pathlib.Path, check: bool) -> int:
+  """Rewrite hash values in `path`, returns number of corrected entries."""
+  lines = path.read_text(encoding="utf-8").splitlines(keepends=True)
+  fixed = 0
+  for i, line in enumerate(lines):
+    match = ENTRY.match(line.rstrip("\r\n"))
+    if not match:
+      continue
+    indent, name, word, value, comma, rest = match.groups()
+    comment = WORD.search(rest)
+    word = comment.group(1) if comment else word.lower()
+    correct = hash_djb2(word)
+    if int(value) == correct:
+      continue
+    fixed += 1
+    print(f"{path}:{i + 1}: {name} = {correct} ({word})")
+    eol = line[len(line.rstrip("\r\n")):]
+    lines[i] = f"{indent}{name} = {correct}{comma}{rest}{eol}"
+  if fixed and not check:
+    path.write_text("".join(lines), encoding="utf-8")
+  return fixed
+
+if __name__ == "__main__":
+  parser = argparse.ArgumentParser(description="Update djb2 hash enums of bash commands")
+  parser.add_argument("files", nargs="*", help="Header files (default: lib/ and plc/ headers)")
+  parser.add_argument("--check", action="store_true", help="Only verify values")
+  args = parser.parse_args()
+  root = pathlib.Path(__file__).resolve().parents[2]
+  files = [pathlib.Path(f) for f in args.files] or sorted(
+    [*root.glob("lib/**/*.h"), *root.glob("plc/**/*.h")])
+  fixed = sum(update(path, args.check) for path in files)
+  sys.exit(1 if args.check and fixed else 0)
@@ -0,0 +1,164 @@
+#!/usr/bin/env python3
+"""
+Decoder of binary log records queued by `LOG_BIN` (`LOG_BINARY` mode).
+Records arrive as `FRAME_Op_Log` frames (`0x00 <COBS> 0x00`, see `frame.py`), format strings
+are read from `log_fmt` section of firmware ELF file. Text output of the debug port
+(bash, `print`, critical logs) is passed through unchanged, other frames are skipped.
+
+  python log-decode.py build/app.elf capture.bin
+  python log-decode.py build/app.elf --port COM3 --baud 115200
+"""
+
+import argparse
+import struct
+import sys
+from frame import OP_LOG, REPLY, cobs_decode, crc16_modbus
+
+LEVELS = ["DBG", "INF", "WRN", "ERR", "CRT", "PNC"]
+COLORS = ["\033[32m", "\033[34m", "\033[33m", "\033[31m", "\033[35m", "\033[35m"]
+HEADER = 8
+
+def elf_section(path: str, name: str) -> bytes:
+  """Returns content of ELF32 little-endian section `name`."""
+  with open(path, "rb") as file:
+    elf = file.read()
+  if elf[:4] != b"\x7fELF" or elf[4] != 1:
+    raise ValueError(f"{path} is not ELF32 file")
+  shoff, = struct.unpack_from("<I", elf, 0x20)
+  shentsize, shnum, shstrndx = struct.unpack_from("<HHH", elf, 0x2E)
+  def header(i: int):
+    return struct.unpack_from("<IIIIIIIIII", elf, shoff + i * shentsize)
+  strtab = header(shstrndx)
+  for i in range(shnum):
+    sh = header(i)
+    start = strtab[4] + sh[0]
+    if elf[start:elf.index(b"\0", start)].decode() == name:
+      return elf[sh[4]:sh[4] + sh[5]]
+  raise ValueError(f"Section {name} not found in {path}")
+
+class Payload:
+  def __init__(self, data: bytes):
+    self.data = data
+    self.pos = 0
+
+  def take(self, size: int) -> bytes:
+    chunk = self.data[self.pos:self.pos + size]
+    self.pos += size
+    if len(chunk) < size:
+      raise EOFError
+    return chunk
+
+  def unpack(self, fmt: str):
+    return struct.unpack("<" + fmt, self.take(struct.calcsize("<" + fmt)))[0]
+
+  def string(self) -> str:
+    return self.take(self.unpack("B")).decode(errors="replace")
+
+def int_text(nbr: int, base: int, fill_zero: int, fill_space: int) -> str:
+  digits = format(abs(nbr), {2: "b", 10: "d", 16: "X"}[base])
+  sign = "-" if nbr < 0 else ""
+  digits = digits.rjust(max(fill_zero - len(sign), 0), "0")
+  return (sign + digits).rjust(fill_space)
+
+def render(fmt: str, payload: Payload) -> str:
+  """Mirror of `print_args` with arguments taken from record payload (see `LOG_BIN_TYPE`)."""
+  out = []
+  i = 0
+  def number() -> int:
+    nonlocal i
+    start = i
+    while i < len(fmt) and fmt[i].isdigit(): i += 1
+    return int(fmt[start:i]) if i > start else 0
+  while i < len(fmt):
+    if fmt[i] != "%":
+      out.append(fmt[i])
+      i += 1
+      continue
+    i += 1
+    width = number()
+    if i < len(fmt) and fmt[i] == "-": i += 1
+    precision, default_precision = 0, True
+    if i < len(fmt) and fmt[i] == ".":
+      i += 1
+      precision, default_precision = number(), False
+    long_int = False
+    while i < len(fmt) and fmt[i] == "l":
+      long_int = True
+      i += 1
+    if i >= len(fmt): break
+    kind = fmt[i]
+    i += 1
+    if kind == "%":
+      out.append("%")
+      continue
+    if default_precision and kind in "fF": precision = 2
+    fill = max(precision, width)
+    if kind in "id": out.append(int_text(payload.unpack("q" if long_int else "i"), 10, width, precision))
+    elif kind == "u": out.append(int_text(payload.unpack("Q" if long_int else "I"), 10, width, precision))
+    elif kind in "xX": out.append(int_text(payload.unpack("Q" if long_int else "I"), 16, fill, fill))
+    elif kind == "b": out.append(int_text(payload.unpack("I"), 2, fill, fill))
+    elif kind in "fF": out.append(f"{payload.unpack('f'):{width}.{precision}f}")
+    elif kind == "B": out.append("true" if payload.unpack("I") else "false")
+    elif kind == "c": out.append(chr(payload.unpack("I") & 0xFF))
+    elif kind == "s": out.append(payload.string())
+    else: out.append(f"<%{kind}>")  # Arrays and objects are not supported in binary records
+  return "".join(out)
+
+def decode(stream, formats: bytes, colors: bool):
+  """Reads bytes from `stream` and writes text with decoded records to stdout."""
+  def read() -> bytes:
+    byte = stream.read(1)
+    if not byte: raise EOFError
+    return byte
+  try:
+    while True:
+      byte = read()
+      if byte != b"\0":
+        sys.stdout.write(byte.decode("latin-1"))
+        continue
+      frame = bytearray()
+      while not frame or frame[-1]:
+        byte = read()
+        if byte == b"\0" and not frame: continue
+        frame += byte
+      try:
+        data = cobs_decode(bytes(frame[:-1]))
+      except ValueError:
+        continue
+      if len(data) < 5 + HEADER or crc16_modbus(data[:-2]) != struct.unpack("<H", data[-2:])[0]:
+        continue
+      if data[0] or data[1] != OP_LOG | REPLY:
+        continue  # Replies of `frame.py` requests
+      level, id, ms, size = struct.unpack_from("<BHIB", data, 3)
+      payload = Payload(data[3 + HEADER:-2][:size])
+      end = formats.find(b"\0", id)
+      fmt = formats[id:end].decode(errors="replace") if 0 <= id < len(formats) else f"<unknown id {id}>"
+      try:
+        text = render(fmt, payload)
+      except EOFError:
+        text = render(fmt, Payload(payload.data + bytes(256))) + " <truncated>"
+      name = LEVELS[level] if level < len(LEVELS) else "???"
+      stamp = f"{ms / 1000:12.3f}"
+      if colors: sys.stdout.write(f"{stamp} {COLORS[level % len(COLORS)]}{name}\033[0m {text}\n")
+      else: sys.stdout.write(f"{stamp} {name}: {text}\n")
+      sys.stdout.flush()
+  except EOFError:
+    pass
+
+if __name__ == "__main__":
+  parser = argparse.ArgumentParser(description="Decode OpenCPLC binary log stream")
+  parser.add_argument("elf", help="Firmware ELF file with log_fmt section")
+  parser.add_argument("input", nargs="?", default="-", help="Captured stream file, '-' for stdin")
+  parser.add_argument("--port", help="Serial port (requires pyserial)")
+  parser.add_argument("--baud", type=int, default=115200)
+  parser.add_argument("--no-colors", action="store_true")
+  args = parser.parse_args()
+  formats = elf_section(args.elf, "log_fmt")
+  if args.port:
+    import serial
+    stream = serial.Serial(args.port, args.baud)
+  elif args.input == "-":
+    stream = sys.stdin.buffer
+  else:
+    stream = open(args.input, "rb")
+  decode(stream, formats, not args.no_colors)
@@ -1,6 +1,17 @@
 #include "log.h"
+#if(LOG_BINARY)
+  #include "frame.h"
+#endif
 
 bool LogPrintFlag = true;
+uint32_t LogBinaryLost; // Binary records dropped on full ring
+
+LOG_Modules_t LogModules = {
+  .name = { "main" },
+  .hash = { 2090499946 }, // hash_djb2("main")
+  .level = { [0 ... LOG_MODULE_LIMIT - 1] = LOG_LEVEL },
+  .count = 1
+};
 
 static uint8_t print_args_getstrnbr(const char **format)
 {
@@ -257,22 +268,43 @@ void print(const char *template, ...)
 
 //------------------------------------------------------------------------------------------------- Log
 
+/**
+ * @brief Timestamp text of current second, rendered once per second.
+ * @param time Raw `RTC->TR` value the text was rendered from.
+ * @param date Raw `RTC->DR` value the text was rendered from.
+ * @param text Rendered date and time (without milliseconds).
+ * @param size Length of `text`, `0` if not rendered yet.
+ */
+static struct {
+  uint32_t time;
+  uint32_t date;
+  char text[20];
+  uint8_t size;
+} log_stamp;
+
 inline static void LOG_Datetime(void)
 {
   if(rtc_init) {
-    RTC_Datetime_t dt = RTC_Datetime();
-    #if(LOG_INCLUDE_MS)
+    uint32_t time, date;
+    uint16_t ms = RTC_Raw(&time, &date);
+    if(!log_stamp.size || time != log_stamp.time || date != log_stamp.date) {
+      RTC_Datetime_t dt = RTC_RawToDatetime(time, date);
+      FILE_t file = { .buffer = (uint8_t *)log_stamp.text, .limit = sizeof(log_stamp.text) };
       #if(LOG_TIME_ONLY)
-        DBG_TimeMs(&dt);
+        FILE_Time(&file, &dt);
       #else
-        DBG_DatetimeMs(&dt);
+        FILE_Datetime(&file, &dt);
       #endif
+      log_stamp.time = time;
+      log_stamp.date = date;
+      log_stamp.size = file.size;
+    }
+    DBG_Data((uint8_t *)log_stamp.text, log_stamp.size);
+    #if(LOG_INCLUDE_MS)
+      DBG_Char('.');
+      DBG_Int(ms, 10, false, 3, 3);
     #else
-      #if(LOG_TIME_ONLY)
-        DBG_Time(&dt);
-      #else
-        DBG_Datetime(&dt);
-      #endif
+      (void)ms;
     #endif
   }
   else {
@@ -337,7 +369,7 @@ void LOG_Bash(const char *message, ...)
 static void LOG_DebugArgs(const char *message, va_list args)
 {
   #if(LOG_LEVEL <= LOG_LEVEL_DBG)
-    if(!LogPrintFlag) return;
+    if(!LogPrintFlag || !LOG_IsEnabled(LOG_MODULE_MAIN, LOG_Level_Debug)) return;
     LOG_Datetime();
     #if(LOG_COLORS)
       DBG_String(ANSI_GREEN "DBG " ANSI_END);
@@ -360,7 +392,7 @@ void LOG_Debug(const char *message, ...)
 static void LOG_InfoArgs(const char *message, va_list args)
 {
   #if(LOG_LEVEL <= LOG_LEVEL_INF)
-    if(!LogPrintFlag) return;
+    if(!LogPrintFlag || !LOG_IsEnabled(LOG_MODULE_MAIN, LOG_Level_Info)) return;
     LOG_Datetime();
     #if(LOG_COLORS)
       DBG_String(ANSI_BLUE "INF " ANSI_END);
@@ -383,7 +415,7 @@ void LOG_Info(const char *message, ...)
 static void LOG_WarningArgs(const char *message, va_list args)
 {
   #if(LOG_LEVEL <= LOG_LEVEL_WRN)
-    if(!LogPrintFlag) return;
+    if(!LogPrintFlag || !LOG_IsEnabled(LOG_MODULE_MAIN, LOG_Level_Warning)) return;
     LOG_Datetime();
     #if(LOG_COLORS)
       DBG_String(ANSI_YELLOW "WRN " ANSI_END);
@@ -406,7 +438,7 @@ void LOG_Warning(const char *message, ...)
 static void LOG_ErrorArgs(const char *message, va_list args)
 {
   #if(LOG_LEVEL <= LOG_LEVEL_ERR)
-    if(!LogPrintFlag) return;
+    if(!LogPrintFlag || !LOG_IsEnabled(LOG_MODULE_MAIN, LOG_Level_Error)) return;
     LOG_Datetime();
     #if(LOG_COLORS)
       DBG_String(ANSI_RED "ERR " ANSI_END);
@@ -472,6 +504,7 @@ void LOG_Panic(const char *message)
 
 void LOG_Message(LOG_Level_e lvl, char *message, ...)
 {
+  if(!LOG_IsEnabled(LOG_MODULE_MAIN, lvl)) return;
   va_list args;
   va_start(args, message);
   switch(lvl) {
@@ -486,6 +519,235 @@ void LOG_Message(LOG_Level_e lvl, char *message, ...)
   va_end(args);
 }
 
+//------------------------------------------------------------------------------------------------- Module
+
+/**
+ * @brief Register log module with own runtime level (starts at `LOG_LEVEL`).
+ *   Registering the same name again returns existing ID.
+ * @param name Module name (static string), e.g. `"modbus"`.
+ * @return Module ID for `LOG_Module`, `LOG_MODULE_MAIN` if limit is exceeded.
+ */
+uint8_t LOG_AddModule(const char *name)
+{
+  uint8_t mod = LOG_FindModule(name);
+  if(mod != LOG_MODULE_NONE) return mod;
+  if(LogModules.count >= LOG_MODULE_LIMIT) {
+    LOG_Error("LOG Exceeded module limit (max:%u)", LOG_MODULE_LIMIT);
+    return LOG_MODULE_MAIN;
+  }
+  mod = LogModules.count;
+  LogModules.name[mod] = name;
+  LogModules.hash[mod] = hash_djb2_ci(name);
+  LogModules.count++;
+  return mod;
+}
+
+/**
+ * @brief Find registered log module by name (case-insensitive).
+ * @param name Module name.
+ * @return Module ID or `LOG_MODULE_NONE` if not registered.
+ */
+uint8_t LOG_FindModule(const char *name)
+{
+  uint32_t hash = hash_djb2_ci(name);
+  for(uint8_t i = 0; i < LogModules.count; i++) {
+    if(hash == LogModules.hash[i]) return i;
+  }
+  return LOG_MODULE_NONE;
+}
+
+/**
+ * @brief Set runtime log level of module.
+ * @param mod Module ID, `LOG_MODULE_MAIN` for untagged logs.
+ * @param lvl Minimum level printed, `LOG_Level_None` mutes module.
+ */
+void LOG_SetLevel(uint8_t mod, LOG_Level_e lvl)
+{
+  if(mod < LogModules.count) LogModules.level[mod] = lvl;
+}
+
+static const char *const log_labels[] = {
+  #if(LOG_COLORS)
+    ANSI_GREEN "DBG " ANSI_END, ANSI_BLUE "INF " ANSI_END, ANSI_YELLOW "WRN " ANSI_END, ANSI_RED "ERR " ANSI_END
+  #else
+    "DBG: ", "INF: ", "WRN: ", "ERR: "
+  #endif
+};
+
+/**
+ * @brief Log message of registered module, filtered by its runtime level before any formatting.
+ *   Module name is appended as tag, same as `LOG_LIB`.
+ * @param mod Module ID returned by `LOG_AddModule`.
+ * @param lvl Log level.
+ * @param message Format string (`print` syntax).
+ */
+void LOG_Module(uint8_t mod, LOG_Level_e lvl, const char *message, ...)
+{
+  if(!LOG_IsEnabled(mod, lvl)) return;
+  va_list args;
+  va_start(args, message);
+  if(lvl >= LOG_Level_Critical) {
+    if(lvl == LOG_Level_Critical) LOG_CriticalArgs(message, args);
+    else if(lvl == LOG_Level_Panic) LOG_Panic(message);
+  }
+  else if(LogPrintFlag) {
+    LOG_Datetime();
+    DBG_String((char *)log_labels[lvl]);
+    print_args(message, args);
+    #if(LOG_COLORS)
+      DBG_String(ANSI_GREY " <" ANSI_ORANGE);
+      DBG_String((char *)LogModules.name[mod]);
+      DBG_String(ANSI_GREY ">" ANSI_END);
+    #else
+      DBG_String(" <");
+      DBG_String((char *)LogModules.name[mod]);
+      DBG_Char('>');
+    #endif
+    DBG_Enter();
+  }
+  va_end(args);
+}
+
+//------------------------------------------------------------------------------------------------- Binary
+#if(LOG_BINARY)
+
+/*
+ * Binary record: level, ID (LE16), timestamp in ms (LE32), payload length and payload.
+ * Payload holds arguments in order, as encoded by `LOG_BIN_TYPE`: integers 4 or 8 bytes,
+ * floats as `float`, strings with 1-byte length prefix. On output every record is sent as
+ * `FRAME_Op_Log` frame (`0x00 <COBS> 0x00`), so it never mixes with text or frame replies.
+ */
+
+#define LOG_BINARY_MASK (LOG_BINARY_SIZE - 1)
+#define LOG_BINARY_HEADER 8
+#define LOG_BINARY_FRAME (3 + LOG_BINARY_HEADER + LOG_BINARY_PAYLOAD + 2) // id, opcode, status and CRC
+
+static uint8_t log_ring[LOG_BINARY_SIZE];
+static volatile uint16_t log_head; // Written only by producer (`LOG_Binary`)
+static volatile uint16_t log_tail; // Written only by consumer (`LOG_BinaryRead`)
+
+typedef struct {
+  uint8_t data[LOG_BINARY_HEADER + LOG_BINARY_PAYLOAD];
+  uint8_t size;
+} LOG_Record_t;
+
+static void LOG_Put(LOG_Record_t *rec, const void *data, uint16_t size)
+{
+  uint16_t space = sizeof(rec->data) - rec->size;
+  if(size > space) size = space;
+  memcpy(&rec->data[rec->size], data, size);
+  rec->size += size;
+}
+
+static void LOG_PutString(LOG_Record_t *rec, const char *str)
+{
+  size_t len = str ? strlen(str) : 0;
+  uint8_t size = len > 255 ? 255 : (uint8_t)len;
+  LOG_Put(rec, &size, 1);
+  LOG_Put(rec, str, size);
+}
+
+/**
+ * @brief Queue binary log record instead of formatting text (backend of `LOG_BIN`).
+ *   Costs only copy of raw arguments by their compile-time type codes; digits, colors and
+ *   timestamp text are produced on the host. Ring is lock-free single-producer/single-consumer,
+ *   so it may be used from any thread (VRTS switches only in `let`), but not from interrupts.
+ * @param lvl Log level.
+ * @param id Offset of message in `log_fmt` section.
+ * @param types Argument type codes (`LOG_BIN_TYPE`), `0`-terminated.
+ */
+void LOG_Binary(LOG_Level_e lvl, uint16_t id, const char *types, ...)
+{
+  if(lvl >= LOG_Level_None || !LOG_IsEnabled(LOG_MODULE_MAIN, lvl) || !LogPrintFlag) return;
+  LOG_Record_t rec;
+  uint32_t ms = tick_to_ms(tick_read());
+  rec.data[0] = (uint8_t)lvl;
+  memcpy(&rec.data[1], &id, 2);
+  memcpy(&rec.data[3], &ms, 4);
+  rec.size = LOG_BINARY_HEADER;
+  va_list args;
+  va_start(args, types);
+  for(; *types; types++) {
+    switch(*types) {
+      case 'i': {
+        uint32_t nbr = va_arg(args, uint32_t);
+        LOG_Put(&rec, &nbr, 4);
+        break;
+      }
+      case 'q': {
+        uint64_t nbr = va_arg(args, uint64_t);
+        LOG_Put(&rec, &nbr, 8);
+        break;
+      }
+      case 'f': {
+        float nbr = (float)va_arg(args, double);
+        LOG_Put(&rec, &nbr, 4);
+        break;
+      }
+      case 's': LOG_PutString(&rec, va_arg(args, char *)); break;
+    }
+  }
+  va_end(args);
+  rec.data[7] = rec.size - LOG_BINARY_HEADER;
+  uint16_t head = log_head;
+  if(LOG_BINARY_SIZE - (uint16_t)(head - log_tail) < rec.size) {
+    LogBinaryLost++;
+    return;
+  }
+  uint16_t pos = head & LOG_BINARY_MASK;
+  uint16_t first = LOG_BINARY_SIZE - pos;
+  if(first > rec.size) first = rec.size;
+  memcpy(&log_ring[pos], rec.data, first);
+  memcpy(log_ring, &rec.data[first], rec.size - first);
+  __DMB();
+  log_head = head + rec.size; // Publish complete record
+}
+
+/**
+ * @brief Number of binary log bytes waiting in ring (always whole records, before framing).
+ * @return Byte count.
+ */
+uint16_t LOG_BinarySize(void)
+{
+  return (uint16_t)(log_head - log_tail);
+}
+
+/**
+ * @brief Move whole binary log records from ring to `buffer`, each as `FRAME_Op_Log` frame.
+ * @param[out] buffer Destination buffer.
+ * @param[in] size Space in `buffer`, records that do not fit stay in ring.
+ * @return Number of bytes written.
+ */
+uint16_t LOG_BinaryRead(uint8_t *buffer, uint16_t size)
+{
+  uint16_t tail = log_tail;
+  uint16_t written = 0;
+  uint8_t frame[LOG_BINARY_FRAME];
+  while(tail != log_head) {
+    uint16_t record = LOG_BINARY_HEADER + log_ring[(tail + 7) & LOG_BINARY_MASK];
+    uint16_t length = 3 + record + 2;
+    if(written + length + length / 254 + 3 > size) break;
+    frame[0] = 0; // Device-originated frames have ID `0`
+    frame[1] = FRAME_Op_Log | FRAME_REPLY;
+    frame[2] = FRAME_Status_Ok;
+    uint16_t pos = tail & LOG_BINARY_MASK;
+    uint16_t first = LOG_BINARY_SIZE - pos;
+    if(first > record) first = record;
+    memcpy(&frame[3], &log_ring[pos], first);
+    memcpy(&frame[3 + first], log_ring, record - first);
+    length = CRC_Append(&FRAME_CRC, frame, 3 + record);
+    buffer[written++] = 0x00;
+    written += cobs_encode(frame, length, &buffer[written]);
+    buffer[written++] = 0x00;
+    tail += record;
+  }
+  __DMB();
+  log_tail = tail;
+  return written;
+}
+
+#endif
+
 //-------------------------------------------------------------------------------------------------
 
 void LOG_ErrorParse(const char *value, const char *type)
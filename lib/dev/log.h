@@ -27,6 +27,23 @@
   #define LOG_COLORS 1
 #endif
 
+// Binary (deferred) mode of `LOG_DBG`, `LOG_INF`, `LOG_WRN` and `LOG_ERR`: only message ID,
+// timestamp and raw arguments are queued and sent as COBS frames (`FRAME_Op_Log`),
+// text is restored on the host by `log-decode.py`
+#ifndef LOG_BINARY
+  #define LOG_BINARY 0
+#endif
+
+// Size of binary log ring in bytes (power of two)
+#ifndef LOG_BINARY_SIZE
+  #define LOG_BINARY_SIZE 1024
+#endif
+
+// Max argument bytes of one binary log record, up to 247 (longer payload is truncated)
+#ifndef LOG_BINARY_PAYLOAD
+  #define LOG_BINARY_PAYLOAD 64
+#endif
+
 #if(LOG_COLORS)
   #define LOG_LIB(name) ANSI_GREY " <" ANSI_ORANGE name ANSI_GREY ">" ANSI_END
 #else
@@ -55,9 +72,47 @@ typedef enum {
   #define LOG_LEVEL LOG_LEVEL_INF
 #endif
 
+// Max number of log modules with own runtime level (module `0` is `main`)
+#ifndef LOG_MODULE_LIMIT
+  #define LOG_MODULE_LIMIT 16
+#endif
+
+#define LOG_MODULE_MAIN 0
+#define LOG_MODULE_NONE 0xFF
+
+/**
+ * @brief Runtime log levels of registered modules, indexed by module ID.
+ *   Every level starts at `LOG_LEVEL`. Level of `main` also filters `LOG_Debug`...`LOG_Error`,
+ *   but these cannot go below compile-time `LOG_LEVEL` (lower levels are not compiled in).
+ * @param name Module name, used as tag and in `log` bash command.
+ * @param level Minimum level printed for the module.
+ * @param count Number of registered modules.
+ */
+typedef struct {
+  const char *name[LOG_MODULE_LIMIT];
+  uint32_t hash[LOG_MODULE_LIMIT];
+  LOG_Level_e level[LOG_MODULE_LIMIT];
+  uint8_t count;
+} LOG_Modules_t;
+
+extern LOG_Modules_t LogModules;
+
+/**
+ * @brief Check runtime level of module before any formatting.
+ *   Runtime level filters only `Debug`…`Error`, critical and panic messages always pass.
+ * @param mod Module ID returned by `LOG_AddModule`.
+ * @param lvl Log level of message.
+ * @return `true` if message would be printed.
+ */
+static inline bool LOG_IsEnabled(uint8_t mod, LOG_Level_e lvl)
+{
+  return mod < LogModules.count && (lvl >= LOG_Level_Critical || lvl >= LogModules.level[mod]);
+}
+
 //-------------------------------------------------------------------------------------------------
 
 extern bool LogPrintFlag;
+extern uint32_t LogBinaryLost;
 
 void print(const char *template, ...);
 void LOG_Init(const char *greeting, const char *version);
@@ -70,14 +125,75 @@ void LOG_Error(const char *message, ...);
 void LOG_Critical(const char *message, ...);
 void LOG_Panic(const char *message);
 void LOG_Message(LOG_Level_e lvl, char *message, ...);
+uint8_t LOG_AddModule(const char *name);
+uint8_t LOG_FindModule(const char *name);
+void LOG_SetLevel(uint8_t mod, LOG_Level_e lvl);
+void LOG_Module(uint8_t mod, LOG_Level_e lvl, const char *message, ...);
+void LOG_Binary(LOG_Level_e lvl, uint16_t id, const char *types, ...);
+uint16_t LOG_BinarySize(void);
+uint16_t LOG_BinaryRead(uint8_t *buffer, uint16_t size);
+
+#if(LOG_BINARY)
+  extern const char __start_log_fmt[];
+  extern char LOG_BIN_argument_must_be_number_or_string(void);
+  /**
+   * @brief Type code of `LOG_BIN` argument, chosen at compile time:
+   *   `i` 32-bit integer, `q` 64-bit integer, `f` float, `s` string.
+   *   Other types (arrays, objects) are rejected with non-constant initializer error.
+   */
+  #define LOG_BIN_TYPE(x) _Generic((x), \
+    _Bool: 'i', char: 'i', signed char: 'i', unsigned char: 'i', short: 'i', unsigned short: 'i', \
+    int: 'i', unsigned int: 'i', long: sizeof(long) == 8 ? 'q' : 'i', unsigned long: sizeof(long) == 8 ? 'q' : 'i', \
+    long long: 'q', unsigned long long: 'q', float: 'f', double: 'f', char *: 's', const char *: 's', \
+    default: LOG_BIN_argument_must_be_number_or_string())
+  #define LOG_BIN_COUNT(...) LOG_BIN_COUNT_(0, ##__VA_ARGS__, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+  #define LOG_BIN_COUNT_(_0, _1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, n, ...) n
+  #define LOG_BIN_JOIN(a, b) LOG_BIN_JOIN_(a, b)
+  #define LOG_BIN_JOIN_(a, b) a##b
+  #define LOG_BIN_TYPES(...) LOG_BIN_JOIN(LOG_BIN_TYPES_, LOG_BIN_COUNT(__VA_ARGS__))(__VA_ARGS__)
+  #define LOG_BIN_TYPES_0()
+  #define LOG_BIN_TYPES_1(a) LOG_BIN_TYPE(a),
+  #define LOG_BIN_TYPES_2(a, ...) LOG_BIN_TYPE(a), LOG_BIN_TYPES_1(__VA_ARGS__)
+  #define LOG_BIN_TYPES_3(a, ...) LOG_BIN_TYPE(a), LOG_BIN_TYPES_2(__VA_ARGS__)
+  #define LOG_BIN_TYPES_4(a, ...) LOG_BIN_TYPE(a), LOG_BIN_TYPES_3(__VA_ARGS__)
+  #define LOG_BIN_TYPES_5(a, ...) LOG_BIN_TYPE(a), LOG_BIN_TYPES_4(__VA_ARGS__)
+  #define LOG_BIN_TYPES_6(a, ...) LOG_BIN_TYPE(a), LOG_BIN_TYPES_5(__VA_ARGS__)
+  #define LOG_BIN_TYPES_7(a, ...) LOG_BIN_TYPE(a), LOG_BIN_TYPES_6(__VA_ARGS__)
+  #define LOG_BIN_TYPES_8(a, ...) LOG_BIN_TYPE(a), LOG_BIN_TYPES_7(__VA_ARGS__)
+  #define LOG_BIN_TYPES_9(a, ...) LOG_BIN_TYPE(a), LOG_BIN_TYPES_8(__VA_ARGS__)
+  #define LOG_BIN_TYPES_10(a, ...) LOG_BIN_TYPE(a), LOG_BIN_TYPES_9(__VA_ARGS__)
+  #define LOG_BIN_TYPES_11(a, ...) LOG_BIN_TYPE(a), LOG_BIN_TYPES_10(__VA_ARGS__)
+  #define LOG_BIN_TYPES_12(a, ...) LOG_BIN_TYPE(a), LOG_BIN_TYPES_11(__VA_ARGS__)
+  /**
+   * @brief Queue binary log record. Message must be string literal, it is placed in `log_fmt`
+   *   section and its offset in that section is the record ID. Argument types are encoded
+   *   at compile time (`LOG_BIN_TYPE`), device never reads the message, so `log_fmt` section
+   *   can be marked `(INFO)` in linker script and format strings do not occupy flash at all.
+   *   Up to 12 arguments, numbers and strings only (`%a`, `%S` and `%o` are text-only).
+   * @param lvl Log level.
+   * @param message Format string literal (`print` syntax).
+   */
+  #define LOG_BIN(lvl, message, ...) do { \
+    static const char log_fmt_[] __attribute__((section("log_fmt"), used)) = message; \
+    static const char log_arg_[] = { LOG_BIN_TYPES(__VA_ARGS__) 0 }; \
+    LOG_Binary(lvl, (uint16_t)(log_fmt_ - __start_log_fmt), log_arg_, ##__VA_ARGS__); \
+  } while(0)
+  #define LOG_DBG(...) LOG_BIN(LOG_Level_Debug, __VA_ARGS__)
+  #define LOG_INF(...) LOG_BIN(LOG_Level_Info, __VA_ARGS__)
+  #define LOG_WRN(...) LOG_BIN(LOG_Level_Warning, __VA_ARGS__)
+  #define LOG_ERR(...) LOG_BIN(LOG_Level_Error, __VA_ARGS__)
+#else
+  #define LOG_BIN(lvl, ...) LOG_Message(lvl, __VA_ARGS__)
+  #define LOG_DBG LOG_Debug
+  #define LOG_INF LOG_Info
+  #define LOG_WRN LOG_Warning
+  #define LOG_ERR LOG_Error
+#endif
 
 #define LOG_INI LOG_Init
 #define LOG_NOP LOG_Nope
-#define LOG_DBG LOG_Debug
-#define LOG_INF LOG_Info
-#define LOG_WRN LOG_Warning
-#define LOG_ERR LOG_Error
 #define LOG_CRT LOG_Critical
+#define LOG_MOD LOG_Module
 #define LOG_PAC LOG_Panic
 #define LOG_MSG LOG_Message
 
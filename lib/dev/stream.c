@@ -2,13 +2,39 @@
 
 //-------------------------------------------------------------------------------------------------
 
-uint16_t STREAM_Read(STREAM_t *stream, char ***argv)
+/**
+ * @brief Read one message from stream.
+ *   Command line is split in place by `str_tokenize` (quoting, case from `modify`),
+ *   tokens point into the received buffer and stay valid until next read.
+ * @param stream Stream to read from.
+ * @param argv Caller array for tokens, in data mode `argv[0]` points to package data
+ *   and for binary frame to COBS-encoded frame (without `0x00` marker).
+ * @param limit Capacity of `argv`.
+ * @return Token count, package size in data mode or frame size, `0` if no message.
+ */
+uint16_t STREAM_Read(STREAM_t *stream, char **argv, uint16_t limit)
 {
   if(stream->file) DBG_SetFile(stream->file);
   else DBG_DefaultFile();
   uint16_t length = stream->Size();
   if(length) {
-    char *buffer = stream->Read();
+    char *buffer;
+    if(stream->line && stream->ReadTo && length < stream->line_size) {
+      stream->ReadTo((uint8_t *)stream->line);
+      stream->line[length] = '\0';
+      buffer = stream->line;
+    }
+    else {
+      buffer = stream->Read();
+      if(!buffer) return 0;
+    }
+    #if(STREAM_FRAME)
+      stream->frame = !stream->data_mode && !*buffer;
+      if(stream->frame) {
+        argv[0] = buffer + 1;
+        return length - 1;
+      }
+    #endif
     #if(STREAM_ADDRESS)
       uint8_t address = *buffer;
       if(address != stream->address) return 0;
@@ -16,30 +42,17 @@ uint16_t STREAM_Read(STREAM_t *stream, char ***argv)
       length--;
     #endif
     #if(STREAM_CRC)
-      if(CRC_Error(stream->crc, buffer, length)) return 0;
-      length -= stream_crc->width / 8;
+      if(CRC_Error(stream->crc, (uint8_t *)buffer, length)) return 0;
+      length -= stream->crc->width / 8;
     #endif
     if(stream->data_mode) {
-      char **file;
-      char *loc;
-      file = heap_new(sizeof(char*) + (length * sizeof(char)));
-      loc = (char*)file + sizeof(char*);
-      memcpy(loc, buffer, length);
-      file[0] = loc;
-      *argv = file;
+      argv[0] = buffer;
       return length;
     }
-    else {
-      buffer = str_trim(buffer);
-      int argc = str_explode(argv, buffer, ' ');
-      if(stream->modify == STREAM_Modify_Lowercase || stream->modify == STREAM_Modify_Uppercase) {
-        for(int i = 0; i < argc; i++) {
-          if(stream->modify == STREAM_Modify_Lowercase) str_lower_this((*argv)[i]);
-          else if(stream->modify == STREAM_Modify_Uppercase) str_upper_this((*argv)[i]);
-        }
-      }
-      return (uint8_t)argc;
-    }
+    const char *map = NULL;
+    if(stream->modify == STREAM_Modify_Lowercase) map = LowerCase;
+    else if(stream->modify == STREAM_Modify_Uppercase) map = UpperCase;
+    return str_tokenize(buffer, argv, limit, map);
   }
   return 0;
 }
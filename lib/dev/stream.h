@@ -12,6 +12,11 @@
   #define STREAM_CRC 0
 #endif
 
+// Accept `0x00`-delimited binary frames (`frame.h`) on console streams next to text commands
+#ifndef STREAM_FRAME
+  #define STREAM_FRAME 0
+#endif
+
 //-------------------------------------------------------------------------------------------------
 
 typedef enum {
@@ -20,11 +25,21 @@ typedef enum {
   STREAM_Modify_Uppercase = 2
 } STREAM_Modify_e;
 
+/**
+ * @brief Message stream feeding bash (command line or data packages).
+ *   When `line` and `ReadTo` are set, messages shorter than `line_size` are copied into `line`
+ *   and tokenized in place, so reading commands needs no heap allocation.
+ *   Longer messages fall back to `Read`.
+ *   With `STREAM_FRAME`, message starting with `0x00` is binary frame, `frame` flag is then set.
+ */
 typedef struct {
   const char *name;
   bool data_mode;
   STREAM_Modify_e modify;
   char *(*Read)(void);
+  uint16_t (*ReadTo)(uint8_t *);
+  char *line;
+  uint16_t line_size;
   uint16_t (*Size)(void);
   void (*Send)(uint8_t *, uint16_t);
   uint16_t packages;
@@ -37,11 +52,14 @@ typedef struct {
   #if(STREAM_CRC)
     CRC_t *crc;
   #endif
+  #if(STREAM_FRAME)
+    bool frame;
+  #endif
 } STREAM_t;
 
 //-------------------------------------------------------------------------------------------------
 
-uint16_t STREAM_Read(STREAM_t *stream, char ***argv);
+uint16_t STREAM_Read(STREAM_t *stream, char **argv, uint16_t limit);
 void STREAM_DataMode(STREAM_t *stream);
 void STREAM_ArgsMode(STREAM_t *stream);
 
@@ -157,6 +157,130 @@ bool ary_remove(ary_t *ary, uint16_t index, void *out)
   return true;
 }
 
+//------------------------------------------------------------------------------------------------- sorted
+
+/**
+ * @brief Finds the first element that is not less than `key` (bisection, requires `Compare`).
+ * @param ary Pointer to the sorted ary_t structure.
+ * @param key Pointer to the key element.
+ * @return Index of the first element `>= key`, or `count` if there is none.
+ */
+uint16_t ary_lower_bound(const ary_t *ary, const void *key)
+{
+  uint16_t lo = 0, hi = ary->count;
+  while(lo < hi) {
+    uint16_t mid = (uint16_t)((lo + hi) >> 1);
+    if(ary->Compare((uint8_t*)ary->value + mid * ary->element_size, key) < 0) lo = mid + 1;
+    else hi = mid;
+  }
+  return lo;
+}
+
+/**
+ * @brief Finds the first element that is greater than `key` (bisection, requires `Compare`).
+ * @param ary Pointer to the sorted ary_t structure.
+ * @param key Pointer to the key element.
+ * @return Index of the first element `> key`, or `count` if there is none.
+ */
+uint16_t ary_upper_bound(const ary_t *ary, const void *key)
+{
+  uint16_t lo = 0, hi = ary->count;
+  while(lo < hi) {
+    uint16_t mid = (uint16_t)((lo + hi) >> 1);
+    if(ary->Compare((uint8_t*)ary->value + mid * ary->element_size, key) <= 0) lo = mid + 1;
+    else hi = mid;
+  }
+  return lo;
+}
+
+/**
+ * @brief Looks up an element equal to `key` in a sorted array.
+ * @param ary Pointer to the sorted ary_t structure.
+ * @param key Pointer to the key element (only fields used by `Compare` matter).
+ * @return Index of the first matching element, or -1 if not found.
+ */
+int32_t ary_find(const ary_t *ary, const void *key)
+{
+  uint16_t index = ary_lower_bound(ary, key);
+  if(index == ary->count) return -1;
+  if(ary->Compare((uint8_t*)ary->value + index * ary->element_size, key)) return -1;
+  return index;
+}
+
+/**
+ * @brief Inserts an element keeping the array sorted (after existing equal elements).
+ * @param ary Pointer to the sorted ary_t structure.
+ * @param element Pointer to the new element.
+ * @return true on success, false if array is full.
+ */
+bool ary_insert_sorted(ary_t *ary, const void *element)
+{
+  if(ary->count >= ary->limit) return false;
+  return ary_insert(ary, ary_upper_bound(ary, element), element);
+}
+
+/**
+ * @brief Merges `n` sorted elements into a sorted array in a single backward pass.
+ *   Every element is moved at most once, no temporary buffer is used.
+ * @param ary Pointer to the sorted ary_t structure.
+ * @param elements Pointer to `n` elements sorted with the same `Compare` (must not overlap the array).
+ * @param n Number of elements.
+ * @return true on success, false if they do not all fit (array is left unchanged).
+ */
+bool ary_insert_sorted_n(ary_t *ary, const void *elements, uint16_t n)
+{
+  if((uint32_t)ary->count + n > ary->limit) return false;
+  uint8_t *base = (uint8_t*)ary->value;
+  const uint8_t *src = (const uint8_t*)elements;
+  uint16_t size = ary->element_size;
+  uint32_t i = ary->count, j = n, k = (uint32_t)ary->count + n;
+  while(j) {
+    // On equal keys take the new element first from the back, so it lands after the existing ones
+    if(i && ary->Compare(base + (i - 1) * size, src + (j - 1) * size) > 0) {
+      // Move the whole run of larger existing elements at once
+      uint32_t run = i - 1;
+      while(run && ary->Compare(base + (run - 1) * size, src + (j - 1) * size) > 0) run--;
+      k -= i - run;
+      memmove(base + k * size, base + run * size, (i - run) * size);
+      i = run;
+    }
+    else {
+      k--; j--;
+      memcpy(base + k * size, src + j * size, size);
+    }
+  }
+  ary->count += n;
+  return true;
+}
+
+/**
+ * @brief Merges sorted array `src` into sorted array `ary` (both ordered by `ary->Compare`).
+ * @param ary Pointer to the destination sorted ary_t structure.
+ * @param src Pointer to the source sorted ary_t structure (left unchanged).
+ * @return true on success, false if `src` elements do not fit into `ary`.
+ */
+bool ary_merge(ary_t *ary, const ary_t *src)
+{
+  if(src->element_size != ary->element_size) return false;
+  return ary_insert_sorted_n(ary, src->value, src->count);
+}
+
+/**
+ * @brief Range query on a sorted array: elements `e` with `lo <= e <= hi`.
+ * @param ary Pointer to the sorted ary_t structure.
+ * @param lo Pointer to lower bound key (inclusive).
+ * @param hi Pointer to upper bound key (inclusive).
+ * @param first Pointer where index of the first element in range is stored (can be NULL).
+ * @return Number of elements in range.
+ */
+uint16_t ary_range(const ary_t *ary, const void *lo, const void *hi, uint16_t *first)
+{
+  uint16_t begin = ary_lower_bound(ary, lo);
+  uint16_t end = ary_upper_bound(ary, hi);
+  if(first) *first = begin;
+  return end > begin ? end - begin : 0;
+}
+
 //-------------------------------------------------------------------------------------------------
 
 // #include "ary.h"
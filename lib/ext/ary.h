@@ -12,12 +12,15 @@
  * @param count Current number of elements.
  * @param limit Maximum capacity (elements).
  * @param element_size Size of single element (in bytes).
+ * @param Compare Ordering of sorted array; returns `<0` if `a<b`, `0` if `a==b`, `>0` if `a>b`.
+ *   Required by `ary_find`, `ary_insert_sorted`, `ary_merge` and range functions, `NULL` otherwise.
  */
 typedef struct {
   void *value;
   uint16_t count;
   uint16_t limit;
   uint16_t element_size;
+  int32_t (*Compare)(const void *a, const void *b);
 } ary_t;
 
 /**
@@ -68,6 +71,20 @@ typedef struct {
     .element_size = sizeof(Type) \
   }
 
+/**
+ * @brief Helper macro for static sorted array declaration.
+ * Example: `ary_sorted(myArr, int, 10, int_compare);`
+ * Declares: `int myArr_storage[10]; ary_t myArr = { myArr_storage, 0, 10, sizeof(int), int_compare };`
+ * Keep it ordered by using `ary_insert_sorted`/`ary_merge` instead of `ary_push`/`ary_set`.
+ * @param Name Name of the ary_t variable.
+ * @param Type Data type of the elements.
+ * @param Limit Array capacity (number of elements).
+ * @param Cmp Comparison function `int32_t (*)(const void *, const void *)`.
+ */
+#define ary_sorted(Name, Type, Limit, Cmp) \
+  Type Name##_storage[Limit]; \
+  ary_t Name = { .value = Name##_storage, .count = 0, .limit = Limit, .element_size = sizeof(Type), .Compare = Cmp }
+
 void ary_clear(ary_t *arr);
 bool ary_pop(ary_t *arr, void *out);
 bool ary_push(ary_t *ary, const void *element);
@@ -77,5 +94,12 @@ void *ary_get(ary_t *ary, uint16_t index);
 bool ary_set(ary_t *ary, uint16_t index, const void *element);
 bool ary_insert(ary_t *ary, uint16_t index, const void *element);
 bool ary_remove(ary_t *ary, uint16_t index, void *out);
+uint16_t ary_lower_bound(const ary_t *ary, const void *key);
+uint16_t ary_upper_bound(const ary_t *ary, const void *key);
+int32_t ary_find(const ary_t *ary, const void *key);
+bool ary_insert_sorted(ary_t *ary, const void *element);
+bool ary_insert_sorted_n(ary_t *ary, const void *elements, uint16_t n);
+bool ary_merge(ary_t *ary, const ary_t *src);
+uint16_t ary_range(const ary_t *ary, const void *lo, const void *hi, uint16_t *first);
 
 #endif
\ No newline at end of file
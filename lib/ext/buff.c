@@ -15,6 +15,7 @@ inline void BUFF_Init(BUFF_t *buff)
   buff->msg_head = 0;
   buff->msg_tail = 0;
   buff->break_allow = false;
+  buff->frame = false;
 }
 
 /**
@@ -59,7 +60,7 @@ bool BUFF_Append(BUFF_t *buff, uint8_t value)
   buff->msg_counter++;
   buff->head++;
   if(buff->head >= buff->end_memory) buff->head = buff->memory;
-  if(!buff->console_mode) buff->echo = buff->head;
+  if(!buff->console_mode || buff->frame) buff->echo = buff->head;
   buff->break_allow = true;
   if(buff->head == buff->tail) {
     if(buff->Overflow) buff->Overflow();
@@ -107,6 +108,8 @@ bool BUFF_Pop(BUFF_t *buff, uint8_t *value)
 /**
  * @brief Pushes a byte to the circular buffer (console mode aware).
  *   Handles escape sequences, Enter, Ctrl+C, and line breaks for console input.
+ *   With `frames` enabled, `0x00` starts binary frame stored raw (with leading `0x00` as marker)
+ *   up to next `0x00`. Unfinished command line is dropped, repeated `0x00` is ignored.
  * @param buff Pointer to the buffer structure.
  * @param value Value to push.
  * @return `true` if the value was appended or message ended, `false` if ignored or buffer is full.
@@ -114,6 +117,19 @@ bool BUFF_Pop(BUFF_t *buff, uint8_t *value)
 bool BUFF_Push(BUFF_t *buff, uint8_t value)
 {
   if(buff->console_mode) {
+    if(buff->frames && (buff->frame || !value)) {
+      if(value) return BUFF_Append(buff, value);
+      if(!buff->frame) {
+        while(BUFF_Pop(buff, NULL));
+        buff->frame = true;
+        buff->esc = 0;
+        return BUFF_Append(buff, 0x00);
+      }
+      if(buff->msg_counter <= 1) return false;
+      buff->frame = false;
+      BUFF_Break(buff);
+      return true;
+    }
     if(buff->esc == 1) {
       if(value == '[' || value == 'O') buff->esc = 2;
       else buff->esc = 0;
@@ -164,9 +180,9 @@ uint16_t BUFF_Read(BUFF_t *buff, uint8_t *dst)
     if(buff->tail >= buff->end_memory) buff->tail = buff->memory;
     n--;
   }
+  buff->msg_size[buff->msg_tail] = 0;
   buff->msg_tail++;
   if(buff->msg_tail >= BUFF_MESSAGE_LIMIT) buff->msg_tail = 0;
-  buff->msg_size[buff->msg_tail] = 0;
   return size;
 }
 
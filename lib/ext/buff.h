@@ -18,6 +18,7 @@
  * @param memory Pointer to buffer memory (user)
  * @param size Buffer size in bytes (user)
  * @param console_mode Enable console input mode (user)
+ * @param frames Pass `0x00`-delimited binary frames through console mode unchanged (user)
  * @param Overflow Optional overflow handler (user)
  * @param esc ESC parser state (internal)
  * @param end_memory memory + size (internal)
@@ -29,11 +30,13 @@
  * @param msg_head Message head index (internal)
  * @param msg_tail Message tail index (internal)
  * @param break_allow Allow message break (internal)
+ * @param frame Binary frame is being received (internal)
  */
 typedef struct {
   uint8_t *memory;
   uint16_t size;
   bool console_mode;
+  bool frames;
   uint8_t esc;
   void (*Overflow)(void);
   uint8_t *end_memory;
@@ -45,6 +48,7 @@ typedef struct {
   volatile uint16_t msg_head;
   volatile uint16_t msg_tail;
   bool break_allow;
+  bool frame;
 } BUFF_t;
 
 void BUFF_Init(BUFF_t *buff);
@@ -0,0 +1,353 @@
+#include "dsp.h"
+
+//------------------------------------------------------------------------------------------------- q
+
+/**
+ * @brief Saturates 32-bit value to Q15 range.
+ * @param value Input value.
+ * @return Value limited to `[-32768, 32767]`.
+ */
+q15_t q15_sat(int32_t value)
+{
+  if(value > INT16_MAX) return INT16_MAX;
+  if(value < INT16_MIN) return INT16_MIN;
+  return (q15_t)value;
+}
+
+/**
+ * @brief Saturates 64-bit value to Q31 range.
+ * @param value Input value.
+ * @return Value limited to `[-2^31, 2^31 - 1]`.
+ */
+q31_t q31_sat(int64_t value)
+{
+  if(value > INT32_MAX) return INT32_MAX;
+  if(value < INT32_MIN) return INT32_MIN;
+  return (q31_t)value;
+}
+
+/**
+ * @brief Q15 multiplication with rounding and saturation (`-1 * -1` gives max value).
+ * @param a First factor.
+ * @param b Second factor.
+ * @return Product `a * b` in Q15.
+ */
+q15_t q15_mul(q15_t a, q15_t b)
+{
+  return q15_sat(((int32_t)a * b + (1 << 14)) >> 15);
+}
+
+/**
+ * @brief Q31 multiplication with rounding and saturation (`-1 * -1` gives max value).
+ * @param a First factor.
+ * @param b Second factor.
+ * @return Product `a * b` in Q31.
+ */
+q31_t q31_mul(q31_t a, q31_t b)
+{
+  return q31_sat(((int64_t)a * b + (1 << 30)) >> 31);
+}
+
+//------------------------------------------------------------------------------------------------- fir
+
+/**
+ * @brief Filters one Q15 sample. Products are summed in 64 bits, so no intermediate overflow.
+ * @param[in,out] fir Pointer to `FIR_Q15_t` filter.
+ * @param[in] sample New input sample.
+ * @return Filtered sample.
+ */
+q15_t FIR_Q15_Push(FIR_Q15_t *fir, q15_t sample)
+{
+  uint16_t idx = fir->index;
+  fir->state[idx] = sample;
+  fir->state[idx + fir->taps] = sample;
+  const q15_t *x = &fir->state[idx];
+  const q15_t *b = fir->coeffs;
+  int64_t acc = 0;
+  uint16_t n = fir->taps;
+  while(n >= 2) {
+    acc += (int32_t)x[0] * b[0];
+    acc += (int32_t)x[1] * b[1];
+    x += 2; b += 2; n -= 2;
+  }
+  if(n) acc += (int32_t)x[0] * b[0];
+  fir->index = idx ? idx - 1 : fir->taps - 1;
+  return q15_sat((int32_t)((acc + (1 << 14)) >> 15));
+}
+
+/**
+ * @brief Filters block of Q15 samples (`in` and `out` may be the same buffer).
+ * @param[in,out] fir Pointer to `FIR_Q15_t` filter.
+ * @param[in] in Input samples.
+ * @param[out] out Output samples.
+ * @param[in] count Number of samples.
+ */
+void FIR_Q15_Process(FIR_Q15_t *fir, const q15_t *in, q15_t *out, uint16_t count)
+{
+  for(uint16_t i = 0; i < count; i++) out[i] = FIR_Q15_Push(fir, in[i]);
+}
+
+/**
+ * @brief Filters one Q31 sample. Sum of `|coeffs|` has to stay below `1` to avoid accumulator overflow.
+ * @param[in,out] fir Pointer to `FIR_Q31_t` filter.
+ * @param[in] sample New input sample.
+ * @return Filtered sample.
+ */
+q31_t FIR_Q31_Push(FIR_Q31_t *fir, q31_t sample)
+{
+  uint16_t idx = fir->index;
+  fir->state[idx] = sample;
+  fir->state[idx + fir->taps] = sample;
+  const q31_t *x = &fir->state[idx];
+  const q31_t *b = fir->coeffs;
+  int64_t acc = 0;
+  for(uint16_t n = fir->taps; n; n--) acc += (int64_t)*x++ * *b++;
+  fir->index = idx ? idx - 1 : fir->taps - 1;
+  return q31_sat((acc + (1 << 30)) >> 31);
+}
+
+/**
+ * @brief Filters block of Q31 samples (`in` and `out` may be the same buffer).
+ * @param[in,out] fir Pointer to `FIR_Q31_t` filter.
+ * @param[in] in Input samples.
+ * @param[out] out Output samples.
+ * @param[in] count Number of samples.
+ */
+void FIR_Q31_Process(FIR_Q31_t *fir, const q31_t *in, q31_t *out, uint16_t count)
+{
+  for(uint16_t i = 0; i < count; i++) out[i] = FIR_Q31_Push(fir, in[i]);
+}
+
+//------------------------------------------------------------------------------------------------- biquad
+
+/**
+ * @brief Filters one Q15 sample through all biquad stages.
+ * @param[in,out] iir Pointer to `BIQUAD_Q15_t` filter.
+ * @param[in] sample New input sample.
+ * @return Filtered sample.
+ */
+q15_t BIQUAD_Q15_Push(BIQUAD_Q15_t *iir, q15_t sample)
+{
+  const q15_t *c = iir->coeffs;
+  q15_t *s = iir->state;
+  uint8_t shift = 15 - iir->shift;
+  for(uint8_t i = 0; i < iir->stages; i++, c += 5, s += 4) {
+    int64_t acc = (int32_t)c[0] * sample;
+    acc += (int32_t)c[1] * s[0];
+    acc += (int32_t)c[2] * s[1];
+    acc += (int32_t)c[3] * s[2];
+    acc += (int32_t)c[4] * s[3];
+    q15_t y = q15_sat((int32_t)((acc + (1 << (shift - 1))) >> shift));
+    s[1] = s[0]; s[0] = sample;
+    s[3] = s[2]; s[2] = y;
+    sample = y;
+  }
+  return sample;
+}
+
+/**
+ * @brief Filters block of Q15 samples (`in` and `out` may be the same buffer).
+ * @param[in,out] iir Pointer to `BIQUAD_Q15_t` filter.
+ * @param[in] in Input samples.
+ * @param[out] out Output samples.
+ * @param[in] count Number of samples.
+ */
+void BIQUAD_Q15_Process(BIQUAD_Q15_t *iir, const q15_t *in, q15_t *out, uint16_t count)
+{
+  for(uint16_t i = 0; i < count; i++) out[i] = BIQUAD_Q15_Push(iir, in[i]);
+}
+
+/**
+ * @brief Filters one Q31 sample through all biquad stages.
+ *   Products are reduced to Q60 before summing, so five full-scale terms fit the accumulator.
+ * @param[in,out] iir Pointer to `BIQUAD_Q31_t` filter.
+ * @param[in] sample New input sample.
+ * @return Filtered sample.
+ */
+q31_t BIQUAD_Q31_Push(BIQUAD_Q31_t *iir, q31_t sample)
+{
+  const q31_t *c = iir->coeffs;
+  q31_t *s = iir->state;
+  uint8_t shift = 29 - iir->shift;
+  for(uint8_t i = 0; i < iir->stages; i++, c += 5, s += 4) {
+    int64_t acc = ((int64_t)c[0] * sample) >> 2;
+    acc += ((int64_t)c[1] * s[0]) >> 2;
+    acc += ((int64_t)c[2] * s[1]) >> 2;
+    acc += ((int64_t)c[3] * s[2]) >> 2;
+    acc += ((int64_t)c[4] * s[3]) >> 2;
+    q31_t y = q31_sat((acc + ((int64_t)1 << (shift - 1))) >> shift);
+    s[1] = s[0]; s[0] = sample;
+    s[3] = s[2]; s[2] = y;
+    sample = y;
+  }
+  return sample;
+}
+
+/**
+ * @brief Filters block of Q31 samples (`in` and `out` may be the same buffer).
+ * @param[in,out] iir Pointer to `BIQUAD_Q31_t` filter.
+ * @param[in] in Input samples.
+ * @param[out] out Output samples.
+ * @param[in] count Number of samples.
+ */
+void BIQUAD_Q31_Process(BIQUAD_Q31_t *iir, const q31_t *in, q31_t *out, uint16_t count)
+{
+  for(uint16_t i = 0; i < count; i++) out[i] = BIQUAD_Q31_Push(iir, in[i]);
+}
+
+//------------------------------------------------------------------------------------------------- decimation
+
+/**
+ * @brief Adds sample to moving-average decimator.
+ * @param[in,out] mavg Pointer to `MAVG_t` decimator.
+ * @param[in] sample New input sample.
+ * @param[out] out Average of last `ratio` samples, written when function returns `true`.
+ * @return `true` if new output sample is ready.
+ */
+bool MAVG_Push(MAVG_t *mavg, int16_t sample, int16_t *out)
+{
+  mavg->sum += sample;
+  if(++mavg->count < mavg->ratio) return false;
+  *out = (int16_t)(mavg->sum / (int32_t)mavg->ratio);
+  mavg->sum = 0;
+  mavg->count = 0;
+  return true;
+}
+
+/**
+ * @brief Decimates block of samples with moving-average decimator.
+ * @param[in,out] mavg Pointer to `MAVG_t` decimator.
+ * @param[in] in Input samples.
+ * @param[out] out Output samples (up to `count / ratio + 1`, may be the same buffer as `in`).
+ * @param[in] count Number of input samples.
+ * @return Number of output samples.
+ */
+uint16_t MAVG_Process(MAVG_t *mavg, const int16_t *in, int16_t *out, uint16_t count)
+{
+  uint16_t n = 0;
+  for(uint16_t i = 0; i < count; i++) {
+    if(MAVG_Push(mavg, in[i], &out[n])) n++;
+  }
+  return n;
+}
+
+/**
+ * @brief Adds sample to CIC decimator. Integrators run every sample, combs every `ratio` samples.
+ * @param[in,out] cic Pointer to `CIC_t` decimator.
+ * @param[in] sample New input sample.
+ * @param[out] out Decimated sample (after `shift`), written when function returns `true`.
+ * @return `true` if new output sample is ready.
+ */
+bool CIC_Push(CIC_t *cic, int16_t sample, int32_t *out)
+{
+  // Unsigned arithmetic: wrap-around in integrators cancels out in combs
+  uint32_t x = (uint32_t)(int32_t)sample;
+  for(uint8_t i = 0; i < cic->order; i++) {
+    cic->integrator[i] += x;
+    x = cic->integrator[i];
+  }
+  if(++cic->count < cic->ratio) return false;
+  cic->count = 0;
+  for(uint8_t i = 0; i < cic->order; i++) {
+    uint32_t prev = cic->comb[i];
+    cic->comb[i] = x;
+    x -= prev;
+  }
+  *out = (int32_t)x >> cic->shift;
+  return true;
+}
+
+/**
+ * @brief Decimates block of samples with CIC decimator.
+ * @param[in,out] cic Pointer to `CIC_t` decimator.
+ * @param[in] in Input samples.
+ * @param[out] out Output samples (up to `count / ratio + 1`).
+ * @param[in] count Number of input samples.
+ * @return Number of output samples.
+ */
+uint16_t CIC_Process(CIC_t *cic, const int16_t *in, int32_t *out, uint16_t count)
+{
+  uint16_t n = 0;
+  for(uint16_t i = 0; i < count; i++) {
+    if(CIC_Push(cic, in[i], &out[n])) n++;
+  }
+  return n;
+}
+
+//------------------------------------------------------------------------------------------------- sqrt
+
+/**
+ * @brief Integer square root, bit by bit (shifts and adds only).
+ * @param value Input value.
+ * @return `floor(sqrt(value))`.
+ */
+uint16_t isqrt_u32(uint32_t value)
+{
+  uint32_t root = 0;
+  uint32_t bit = 1u << 30;
+  while(bit > value) bit >>= 2;
+  while(bit) {
+    if(value >= root + bit) {
+      value -= root + bit;
+      root = (root >> 1) + bit;
+    }
+    else root >>= 1;
+    bit >>= 2;
+  }
+  return (uint16_t)root;
+}
+
+/**
+ * @brief Integer square root of 64-bit value, bit by bit (shifts and adds only).
+ * @param value Input value.
+ * @return `floor(sqrt(value))`.
+ */
+uint32_t isqrt_u64(uint64_t value)
+{
+  if(value <= UINT32_MAX) return isqrt_u32((uint32_t)value);
+  uint64_t root = 0;
+  uint64_t bit = (uint64_t)1 << 62;
+  while(bit > value) bit >>= 2;
+  while(bit) {
+    if(value >= root + bit) {
+      value -= root + bit;
+      root = (root >> 1) + bit;
+    }
+    else root >>= 1;
+    bit >>= 2;
+  }
+  return (uint32_t)root;
+}
+
+/**
+ * @brief Root mean square of Q15 samples, integer only.
+ * @param data Input samples.
+ * @param count Number of samples.
+ * @return RMS in Q15, `0` if `count` is `0`.
+ */
+q15_t rms_q15(const q15_t *data, uint16_t count)
+{
+  if(!count) return 0;
+  uint64_t sum = 0;
+  for(uint16_t i = 0; i < count; i++) sum += (uint32_t)((int32_t)data[i] * data[i]);
+  uint32_t root = isqrt_u64(sum / count);
+  return root > INT16_MAX ? INT16_MAX : (q15_t)root;
+}
+
+/**
+ * @brief Root mean square of Q31 samples, integer only (Q62 squares are reduced to Q46 before summing,
+ *   so 65535 of them fit in 64 bits and rounding stays far below 1 LSB of the result).
+ * @param data Input samples.
+ * @param count Number of samples.
+ * @return RMS in Q31, `0` if `count` is `0`.
+ */
+q31_t rms_q31(const q31_t *data, uint16_t count)
+{
+  if(!count) return 0;
+  uint64_t sum = 0;
+  for(uint16_t i = 0; i < count; i++) sum += (uint64_t)((int64_t)data[i] * data[i]) >> 16;
+  uint32_t root = isqrt_u64((sum / count) << 16);
+  return root > INT32_MAX ? INT32_MAX : (q31_t)root;
+}
+
+//-------------------------------------------------------------------------------------------------
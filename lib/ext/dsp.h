@@ -0,0 +1,166 @@
+#ifndef DSP_H_
+#define DSP_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+//-------------------------------------------------------------------------------------------------
+
+// Fixed-point formats: Q15 is `int16_t` in range [-1, 1), Q31 is `int32_t` in range [-1, 1)
+typedef int16_t q15_t;
+typedef int32_t q31_t;
+
+#define Q15(x) ((q15_t)((x) >= 0.9999695 ? 32767 : (x) * 32768.0 + ((x) >= 0 ? 0.5 : -0.5)))
+#define Q31(x) ((q31_t)((x) >= 0.9999999995 ? 2147483647 : (x) * 2147483648.0 + ((x) >= 0 ? 0.5 : -0.5)))
+
+// Max number of integrator/comb stages of `CIC_t`
+#ifndef CIC_ORDER_MAX
+  #define CIC_ORDER_MAX 4
+#endif
+
+//------------------------------------------------------------------------------------------------- fir
+
+/**
+ * @brief FIR filter with circular state: y[n] = sum(coeffs[k] * x[n-k]).
+ *   Every sample is stored twice (`state` has `2 * taps` entries), so the newest `taps` samples
+ *   are always contiguous and the inner loop runs without index wrapping.
+ * @param coeffs Coefficients, `coeffs[0]` applies to newest sample (user).
+ * @param state State buffer of `2 * taps` samples (user, zero-initialized).
+ * @param taps Number of coefficients (user).
+ * @param index Position of newest sample. [internal]
+ */
+typedef struct {
+  const q15_t *coeffs;
+  q15_t *state;
+  uint16_t taps;
+  uint16_t index;
+} FIR_Q15_t;
+
+typedef struct {
+  const q31_t *coeffs;
+  q31_t *state;
+  uint16_t taps;
+  uint16_t index;
+} FIR_Q31_t;
+
+/**
+ * @brief Helper macro for static FIR filter declaration.
+ * Example: `fir_q15_new(myFir, my_coeffs, 16);`
+ * @param Name Name of the `FIR_Q15_t` variable.
+ * @param Coeffs Coefficient array.
+ * @param Taps Number of coefficients.
+ */
+#define fir_q15_new(Name, Coeffs, Taps) \
+  q15_t Name##_state[2 * (Taps)]; \
+  FIR_Q15_t Name = { .coeffs = (Coeffs), .state = Name##_state, .taps = (Taps) }
+
+#define fir_q31_new(Name, Coeffs, Taps) \
+  q31_t Name##_state[2 * (Taps)]; \
+  FIR_Q31_t Name = { .coeffs = (Coeffs), .state = Name##_state, .taps = (Taps) }
+
+//------------------------------------------------------------------------------------------------- biquad
+
+/**
+ * @brief Cascade of biquad sections, direct form I:
+ *   y = (b0*x + b1*x1 + b2*x2 + a1*y1 + a2*y2) << shift
+ *   Feedback coefficients are stored negated (`a1`, `a2` as they are added).
+ *   Coefficients are scaled by `2^-shift` so that values up to `2^shift` fit the format.
+ * @param coeffs `{ b0, b1, b2, a1, a2 }` for every stage (user).
+ * @param state `{ x1, x2, y1, y2 }` for every stage (user, zero-initialized).
+ * @param stages Number of biquad sections (user).
+ * @param shift Coefficient scale, usually `1` (user).
+ */
+typedef struct {
+  const q15_t *coeffs;
+  q15_t *state;
+  uint8_t stages;
+  uint8_t shift;
+} BIQUAD_Q15_t;
+
+typedef struct {
+  const q31_t *coeffs;
+  q31_t *state;
+  uint8_t stages;
+  uint8_t shift;
+} BIQUAD_Q31_t;
+
+/**
+ * @brief Helper macro for static biquad cascade declaration.
+ * Example: `biquad_q15_new(myIir, my_coeffs, 2, 1);`
+ * @param Name Name of the `BIQUAD_Q15_t` variable.
+ * @param Coeffs Coefficient array (`5 * Stages` values).
+ * @param Stages Number of biquad sections.
+ * @param Shift Coefficient scale.
+ */
+#define biquad_q15_new(Name, Coeffs, Stages, Shift) \
+  q15_t Name##_state[4 * (Stages)]; \
+  BIQUAD_Q15_t Name = { .coeffs = (Coeffs), .state = Name##_state, .stages = (Stages), .shift = (Shift) }
+
+#define biquad_q31_new(Name, Coeffs, Stages, Shift) \
+  q31_t Name##_state[4 * (Stages)]; \
+  BIQUAD_Q31_t Name = { .coeffs = (Coeffs), .state = Name##_state, .stages = (Stages), .shift = (Shift) }
+
+//------------------------------------------------------------------------------------------------- decimation
+
+/**
+ * @brief Moving-average (boxcar) decimator: averages every `ratio` samples into one output.
+ * @param ratio Decimation ratio, number of averaged samples (user).
+ * @param sum Running sum. [internal]
+ * @param count Samples accumulated so far. [internal]
+ */
+typedef struct {
+  uint16_t ratio;
+  int32_t sum;
+  uint16_t count;
+} MAVG_t;
+
+/**
+ * @brief CIC (cascaded integrator-comb) decimator with unit differential delay.
+ *   Gain is `ratio^order`, output is shifted right by `shift` (use `order * log2(ratio)` for unity gain).
+ *   Integrators wrap modulo 2^32, result is exact while `16 + order * log2(ratio) <= 32`.
+ * @param order Number of integrator and comb stages, max `CIC_ORDER_MAX` (user).
+ * @param ratio Decimation ratio (user).
+ * @param shift Output right shift (user).
+ * @param integrator Integrator stages. [internal]
+ * @param comb Comb stage delay lines. [internal]
+ * @param count Samples since last output. [internal]
+ */
+typedef struct {
+  uint8_t order;
+  uint16_t ratio;
+  uint8_t shift;
+  uint32_t integrator[CIC_ORDER_MAX];
+  uint32_t comb[CIC_ORDER_MAX];
+  uint16_t count;
+} CIC_t;
+
+//-------------------------------------------------------------------------------------------------
+
+q15_t q15_sat(int32_t value);
+q31_t q31_sat(int64_t value);
+q15_t q15_mul(q15_t a, q15_t b);
+q31_t q31_mul(q31_t a, q31_t b);
+
+q15_t FIR_Q15_Push(FIR_Q15_t *fir, q15_t sample);
+void FIR_Q15_Process(FIR_Q15_t *fir, const q15_t *in, q15_t *out, uint16_t count);
+q31_t FIR_Q31_Push(FIR_Q31_t *fir, q31_t sample);
+void FIR_Q31_Process(FIR_Q31_t *fir, const q31_t *in, q31_t *out, uint16_t count);
+
+q15_t BIQUAD_Q15_Push(BIQUAD_Q15_t *iir, q15_t sample);
+void BIQUAD_Q15_Process(BIQUAD_Q15_t *iir, const q15_t *in, q15_t *out, uint16_t count);
+q31_t BIQUAD_Q31_Push(BIQUAD_Q31_t *iir, q31_t sample);
+void BIQUAD_Q31_Process(BIQUAD_Q31_t *iir, const q31_t *in, q31_t *out, uint16_t count);
+
+bool MAVG_Push(MAVG_t *mavg, int16_t sample, int16_t *out);
+uint16_t MAVG_Process(MAVG_t *mavg, const int16_t *in, int16_t *out, uint16_t count);
+bool CIC_Push(CIC_t *cic, int16_t sample, int32_t *out);
+uint16_t CIC_Process(CIC_t *cic, const int16_t *in, int32_t *out, uint16_t count);
+
+uint16_t isqrt_u32(uint32_t value);
+uint32_t isqrt_u64(uint64_t value);
+q15_t rms_q15(const q15_t *data, uint16_t count);
+q31_t rms_q31(const q31_t *data, uint16_t count);
+
+//-------------------------------------------------------------------------------------------------
+#endif
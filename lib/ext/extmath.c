@@ -93,17 +93,24 @@ float min_f32_NaN(uint16_t count, ...)
 
 //------------------------------------------------------------------------------------------------- sort
 
+// All sort variants share two cores that order keys `value ^ mask` as unsigned numbers:
+// `mask` flips the sign bit for signed types and all bits for descending order.
+
+#define SORT_MASK16_I 0x8000
+#define SORT_MASK32_I 0x80000000u
+
 /**
- * @brief Sorts `uint16_t` array in ascending order (in-place).
+ * @brief Insertion sort of `uint16_t` keys, used for short arrays and introsort partitions.
  * @param array Pointer to array to sort.
  * @param len Number of elements in `array`.
+ * @param mask Key mask.
  */
-void sort_asc_u16(uint16_t *array, uint16_t len)
+static void sort_insertion_16(uint16_t *array, uint16_t len, uint16_t mask)
 {
   for(uint16_t i = 1; i < len; i++) {
     uint16_t key = array[i];
-    int16_t j = i - 1;
-    while(j >= 0 && array[j] > key) {
+    int32_t j = i - 1;
+    while(j >= 0 && (uint16_t)(array[j] ^ mask) > (uint16_t)(key ^ mask)) {
       array[j + 1] = array[j];
       j--;
     }
@@ -112,70 +119,122 @@ void sort_asc_u16(uint16_t *array, uint16_t len)
 }
 
 /**
- * @brief Sorts `int16_t` array in ascending order (in-place).
+ * @brief Heap sort of `uint16_t` keys, introsort fallback when partitioning degenerates.
  * @param array Pointer to array to sort.
  * @param len Number of elements in `array`.
+ * @param mask Key mask.
  */
-void sort_asc_i16(int16_t *array, uint16_t len)
+static void sort_heap_16(uint16_t *array, uint16_t len, uint16_t mask)
 {
-  for(uint16_t i = 1; i < len; i++) {
-    int16_t key = array[i];
-    int16_t j = i - 1;
-    while(j >= 0 && array[j] > key) {
-      array[j + 1] = array[j];
-      j--;
+  for(uint32_t n = len, i = len / 2; n > 1;) {
+    if(i) i--;
+    else {
+      n--;
+      uint16_t t = array[0]; array[0] = array[n]; array[n] = t;
     }
-    array[j + 1] = key;
+    uint32_t root = i;
+    uint16_t value = array[root];
+    while(1) {
+      uint32_t child = 2 * root + 1;
+      if(child >= n) break;
+      if(child + 1 < n && (uint16_t)(array[child + 1] ^ mask) > (uint16_t)(array[child] ^ mask)) child++;
+      if((uint16_t)(array[child] ^ mask) <= (uint16_t)(value ^ mask)) break;
+      array[root] = array[child];
+      root = child;
+    }
+    array[root] = value;
   }
 }
 
 /**
- * @brief Sorts `uint16_t` array in descending order (in-place).
+ * @brief Introsort of `uint16_t` keys, same scheme as `sort_intro_32`. Works in place.
  * @param array Pointer to array to sort.
  * @param len Number of elements in `array`.
+ * @param mask Key mask.
+ * @param depth Remaining partitioning depth before switching to heap sort.
  */
-void sort_desc_u16(uint16_t *array, uint16_t len)
+static void sort_intro_16(uint16_t *array, uint16_t len, uint16_t mask, uint8_t depth)
 {
-  for(uint16_t i = 1; i < len; i++) {
-    uint16_t key = array[i];
-    int16_t j = i - 1;
-    while(j >= 0 && array[j] < key) {
-      array[j + 1] = array[j];
-      j--;
+  while(len >= SORT_INSERTION_LIMIT) {
+    if(!depth--) {
+      sort_heap_16(array, len, mask);
+      return;
+    }
+    uint16_t a = array[0] ^ mask, b = array[len / 2] ^ mask, c = array[len - 1] ^ mask;
+    uint16_t pivot = (a < b) ? ((b < c) ? b : ((a < c) ? c : a)) : ((a < c) ? a : ((b < c) ? c : b));
+    int32_t i = -1, j = len;
+    // Hoare partition: [0, j] <= pivot <= [j + 1, len)
+    while(1) {
+      do i++; while((uint16_t)(array[i] ^ mask) < pivot);
+      do j--; while((uint16_t)(array[j] ^ mask) > pivot);
+      if(i >= j) break;
+      uint16_t t = array[i]; array[i] = array[j]; array[j] = t;
+    }
+    uint16_t left = (uint16_t)(j + 1), right = (uint16_t)(len - left);
+    if(left < right) {
+      sort_intro_16(array, left, mask, depth);
+      array += left;
+      len = right;
+    }
+    else {
+      sort_intro_16(array + left, right, mask, depth);
+      len = left;
     }
-    array[j + 1] = key;
   }
+  sort_insertion_16(array, len, mask);
 }
 
 /**
- * @brief Sorts `int16_t` array in descending order (in-place).
+ * @brief Sorts 16-bit keys with introsort, depth limit `2 * log2(len)`.
  * @param array Pointer to array to sort.
  * @param len Number of elements in `array`.
+ * @param mask Key mask.
  */
-void sort_desc_i16(int16_t *array, uint16_t len)
+static void sort_16(uint16_t *array, uint16_t len, uint16_t mask)
 {
-  for(uint16_t i = 1; i < len; i++) {
-    int16_t key = array[i];
-    int16_t j = i - 1;
-    while(j >= 0 && array[j] < key) {
-      array[j + 1] = array[j];
-      j--;
+  uint8_t depth = 0;
+  for(uint16_t n = len; n > 1; n >>= 1) depth += 2;
+  sort_intro_16(array, len, mask, depth);
+}
+
+/**
+ * @brief Sorts `uint16_t` array in ascending order with two-pass LSD radix sort.
+ *   Faster than `sort_asc_u16` for long arrays, but needs caller-provided scratch memory.
+ * @param array Pointer to array to sort.
+ * @param len Number of elements in `array`.
+ * @param temp Scratch buffer of `len + 256` elements.
+ */
+void sort_radix_u16(uint16_t *array, uint16_t len, uint16_t *temp)
+{
+  uint16_t *count = temp + len;
+  uint16_t *src = array, *dst = temp;
+  for(uint8_t shift = 0; shift < 16; shift += 8) {
+    memset(count, 0, 256 * sizeof(uint16_t));
+    for(uint16_t i = 0; i < len; i++) count[(src[i] >> shift) & 0xFF]++;
+    // Exclusive prefix sum turns counts into bucket start positions
+    uint16_t sum = 0;
+    for(uint16_t d = 0; d < 256; d++) {
+      uint16_t c = count[d];
+      count[d] = sum;
+      sum += c;
     }
-    array[j + 1] = key;
+    for(uint16_t i = 0; i < len; i++) dst[count[(src[i] >> shift) & 0xFF]++] = src[i];
+    uint16_t *swap = src; src = dst; dst = swap;
   }
 }
 
 /**
- * @brief Sorts `uint32_t` array in ascending order (in-place).
+ * @brief Insertion sort of `uint32_t` keys, used for short arrays and introsort partitions.
  * @param array Pointer to array to sort.
  * @param len Number of elements in `array`.
+ * @param mask Key mask.
  */
-void sort_asc_u32(uint32_t *array, uint16_t len)
+static void sort_insertion_32(uint32_t *array, uint16_t len, uint32_t mask)
 {
   for(uint16_t i = 1; i < len; i++) {
     uint32_t key = array[i];
-    int16_t j = i - 1;
-    while(j >= 0 && array[j] > key) {
+    int32_t j = i - 1;
+    while(j >= 0 && (array[j] ^ mask) > (key ^ mask)) {
       array[j + 1] = array[j];
       j--;
     }
@@ -184,39 +243,152 @@ void sort_asc_u32(uint32_t *array, uint16_t len)
 }
 
 /**
- * @brief Sorts `int32_t` array in ascending order (in-place).
+ * @brief Heap sort of `uint32_t` keys, introsort fallback when partitioning degenerates.
  * @param array Pointer to array to sort.
  * @param len Number of elements in `array`.
+ * @param mask Key mask.
  */
-void sort_asc_i32(int32_t *array, uint16_t len)
+static void sort_heap_32(uint32_t *array, uint16_t len, uint32_t mask)
 {
-  for(uint16_t i = 1; i < len; i++) {
-    int32_t key = array[i];
-    int16_t j = i - 1;
-    while(j >= 0 && array[j] > key) {
-      array[j + 1] = array[j];
-      j--;
+  for(uint32_t n = len, i = len / 2; n > 1;) {
+    if(i) i--;
+    else {
+      n--;
+      uint32_t t = array[0]; array[0] = array[n]; array[n] = t;
     }
-    array[j + 1] = key;
+    uint32_t root = i, value = array[root];
+    while(1) {
+      uint32_t child = 2 * root + 1;
+      if(child >= n) break;
+      if(child + 1 < n && (array[child + 1] ^ mask) > (array[child] ^ mask)) child++;
+      if((array[child] ^ mask) <= (value ^ mask)) break;
+      array[root] = array[child];
+      root = child;
+    }
+    array[root] = value;
   }
 }
 
 /**
- * @brief Sorts `uint32_t` array in descending order (in-place).
+ * @brief Introsort of `uint32_t` keys: median-of-three quicksort, heap sort when recursion
+ *   gets too deep and insertion sort for short partitions. Recurses into the smaller part only.
  * @param array Pointer to array to sort.
  * @param len Number of elements in `array`.
+ * @param mask Key mask.
+ * @param depth Remaining partitioning depth before switching to heap sort.
  */
-void sort_desc_u32(uint32_t *array, uint16_t len)
+static void sort_intro_32(uint32_t *array, uint16_t len, uint32_t mask, uint8_t depth)
 {
-  for(uint16_t i = 1; i < len; i++) {
-    uint32_t key = array[i];
-    int16_t j = i - 1;
-    while(j >= 0 && array[j] < key) {
-      array[j + 1] = array[j];
-      j--;
+  while(len >= SORT_INSERTION_LIMIT) {
+    if(!depth--) {
+      sort_heap_32(array, len, mask);
+      return;
+    }
+    uint32_t a = array[0] ^ mask, b = array[len / 2] ^ mask, c = array[len - 1] ^ mask;
+    uint32_t pivot = (a < b) ? ((b < c) ? b : ((a < c) ? c : a)) : ((a < c) ? a : ((b < c) ? c : b));
+    int32_t i = -1, j = len;
+    // Hoare partition: [0, j] <= pivot <= [j + 1, len)
+    while(1) {
+      do i++; while((array[i] ^ mask) < pivot);
+      do j--; while((array[j] ^ mask) > pivot);
+      if(i >= j) break;
+      uint32_t t = array[i]; array[i] = array[j]; array[j] = t;
+    }
+    uint16_t left = (uint16_t)(j + 1), right = (uint16_t)(len - left);
+    if(left < right) {
+      sort_intro_32(array, left, mask, depth);
+      array += left;
+      len = right;
+    }
+    else {
+      sort_intro_32(array + left, right, mask, depth);
+      len = left;
     }
-    array[j + 1] = key;
   }
+  sort_insertion_32(array, len, mask);
+}
+
+/**
+ * @brief Sorts 32-bit keys with introsort, depth limit `2 * log2(len)`.
+ * @param array Pointer to array to sort.
+ * @param len Number of elements in `array`.
+ * @param mask Key mask.
+ */
+static void sort_32(uint32_t *array, uint16_t len, uint32_t mask)
+{
+  uint8_t depth = 0;
+  for(uint16_t n = len; n > 1; n >>= 1) depth += 2;
+  sort_intro_32(array, len, mask, depth);
+}
+
+/**
+ * @brief Sorts `uint16_t` array in ascending order (in-place).
+ * @param array Pointer to array to sort.
+ * @param len Number of elements in `array`.
+ */
+void sort_asc_u16(uint16_t *array, uint16_t len)
+{
+  sort_16(array, len, 0);
+}
+
+/**
+ * @brief Sorts `int16_t` array in ascending order (in-place).
+ * @param array Pointer to array to sort.
+ * @param len Number of elements in `array`.
+ */
+void sort_asc_i16(int16_t *array, uint16_t len)
+{
+  sort_16((uint16_t *)array, len, SORT_MASK16_I);
+}
+
+/**
+ * @brief Sorts `uint16_t` array in descending order (in-place).
+ * @param array Pointer to array to sort.
+ * @param len Number of elements in `array`.
+ */
+void sort_desc_u16(uint16_t *array, uint16_t len)
+{
+  sort_16(array, len, 0xFFFF);
+}
+
+/**
+ * @brief Sorts `int16_t` array in descending order (in-place).
+ * @param array Pointer to array to sort.
+ * @param len Number of elements in `array`.
+ */
+void sort_desc_i16(int16_t *array, uint16_t len)
+{
+  sort_16((uint16_t *)array, len, 0xFFFF ^ SORT_MASK16_I);
+}
+
+/**
+ * @brief Sorts `uint32_t` array in ascending order (in-place).
+ * @param array Pointer to array to sort.
+ * @param len Number of elements in `array`.
+ */
+void sort_asc_u32(uint32_t *array, uint16_t len)
+{
+  sort_32(array, len, 0);
+}
+
+/**
+ * @brief Sorts `int32_t` array in ascending order (in-place).
+ * @param array Pointer to array to sort.
+ * @param len Number of elements in `array`.
+ */
+void sort_asc_i32(int32_t *array, uint16_t len)
+{
+  sort_32((uint32_t *)array, len, SORT_MASK32_I);
+}
+
+/**
+ * @brief Sorts `uint32_t` array in descending order (in-place).
+ * @param array Pointer to array to sort.
+ * @param len Number of elements in `array`.
+ */
+void sort_desc_u32(uint32_t *array, uint16_t len)
+{
+  sort_32(array, len, 0xFFFFFFFF);
 }
 
 /**
@@ -226,15 +398,77 @@ void sort_desc_u32(uint32_t *array, uint16_t len)
  */
 void sort_desc_i32(int32_t *array, uint16_t len)
 {
-  for(uint16_t i = 1; i < len; i++) {
-    int32_t key = array[i];
-    int16_t j = i - 1;
-    while(j >= 0 && array[j] < key) {
-      array[j + 1] = array[j];
-      j--;
+  sort_32((uint32_t *)array, len, 0xFFFFFFFF ^ SORT_MASK32_I);
+}
+
+//------------------------------------------------------------------------------------------------- select
+
+/**
+ * @brief Partially orders `uint16_t` array so that `array[k]` holds the value it would have
+ *   after ascending sort, with no greater value before it and no smaller value after it.
+ *   Quickselect with median-of-three Hoare partitioning, average O(n).
+ *   Falls back to sorting the remaining range if partitioning degenerates.
+ * @param array Pointer to array (reordered in-place).
+ * @param len Number of elements in `array`.
+ * @param k Rank to select, `0` for minimum.
+ */
+void select_u16(uint16_t *array, uint16_t len, uint16_t k)
+{
+  if(k >= len) return;
+  int32_t left = 0, right = len - 1;
+  uint8_t depth = 0;
+  for(uint16_t n = len; n > 1; n >>= 1) depth += 2;
+  while(right - left >= SORT_INSERTION_LIMIT) {
+    if(!depth--) break;
+    uint16_t a = array[left], b = array[(left + right) / 2], c = array[right];
+    uint16_t pivot = (a < b) ? ((b < c) ? b : ((a < c) ? c : a)) : ((a < c) ? a : ((b < c) ? c : b));
+    int32_t i = left - 1, j = right + 1;
+    while(1) {
+      do i++; while(array[i] < pivot);
+      do j--; while(array[j] > pivot);
+      if(i >= j) break;
+      uint16_t t = array[i]; array[i] = array[j]; array[j] = t;
     }
-    array[j + 1] = key;
+    if(k <= j) right = j;
+    else left = j + 1;
   }
+  sort_16(&array[left], (uint16_t)(right - left + 1), 0);
+}
+
+/**
+ * @brief Average of values with ascending-order ranks `[begin, end)`, without full sort.
+ *   Gives exactly the same result as `sort_asc_u16` followed by `avg_u16(&array[begin], end - begin)`,
+ *   but array is only partitioned: ranks `[begin, end)` end up in `array[begin..end)` in any order.
+ * @param array Pointer to array (reordered in-place).
+ * @param len Number of elements in `array`.
+ * @param begin First rank included.
+ * @param end First rank excluded.
+ * @return Average value as `float`. Returns `0` if range is empty.
+ */
+float avg_rank_u16(uint16_t *array, uint16_t len, uint16_t begin, uint16_t end)
+{
+  if(end > len) end = len;
+  if(begin >= end) return 0.0f;
+  select_u16(array, len, begin);
+  if(end < len) select_u16(&array[begin], len - begin, end - begin);
+  return avg_u16(&array[begin], end - begin);
+}
+
+/**
+ * @brief Trimmed mean of `uint16_t` samples: drops the lowest `lo_frac` and the highest `hi_frac`
+ *   part of values and averages the rest, in O(n) using selection instead of sorting.
+ * @param data Pointer to samples (reordered in-place).
+ * @param n Number of samples.
+ * @param lo_frac Fraction of lowest values to drop `[0, 1]`.
+ * @param hi_frac Fraction of highest values to drop `[0, 1]`.
+ * @return Trimmed mean as `float`. Returns `0` if nothing is left.
+ */
+float trimmed_mean_u16(uint16_t *data, uint16_t n, float lo_frac, float hi_frac)
+{
+  uint16_t lo = (uint16_t)(n * lo_frac);
+  uint16_t hi = (uint16_t)(n * hi_frac);
+  if((uint32_t)lo + hi >= n) return 0.0f;
+  return avg_rank_u16(data, n, lo, n - hi);
 }
 
 //------------------------------------------------------------------------------------------------- avg
@@ -841,4 +1075,302 @@ float step_limiter_f32(float input, float prev, float max_delta)
   return prev;
 }
 
+//------------------------------------------------------------------------------------------------- stat
+
+/**
+ * @brief Clears statistics accumulator.
+ * @param[out] stat Pointer to `STAT_t` accumulator.
+ */
+void STAT_Reset(STAT_t *stat)
+{
+  stat->count = 0;
+  stat->min = NaN;
+  stat->max = NaN;
+  stat->mean = 0.0f;
+  stat->m2 = 0.0f;
+}
+
+/**
+ * @brief Adds sample to statistics accumulator (Welford update, single pass, O(1)).
+ * @param[in,out] stat Pointer to `STAT_t` accumulator.
+ * @param[in] value New sample.
+ */
+void STAT_Push(STAT_t *stat, float value)
+{
+  if(!stat->count) {
+    stat->min = value;
+    stat->max = value;
+  }
+  else {
+    if(value < stat->min) stat->min = value;
+    if(value > stat->max) stat->max = value;
+  }
+  stat->count++;
+  float delta = value - stat->mean;
+  stat->mean += delta / stat->count;
+  stat->m2 += delta * (value - stat->mean);
+}
+
+/**
+ * @brief Merges accumulator `src` into `stat` (parallel Welford / Chan update).
+ *   Result equals accumulating both sample sets into one accumulator.
+ * @param[in,out] stat Pointer to destination `STAT_t` accumulator.
+ * @param[in] src Pointer to source `STAT_t` accumulator.
+ */
+void STAT_Merge(STAT_t *stat, const STAT_t *src)
+{
+  if(!src->count) return;
+  if(!stat->count) {
+    *stat = *src;
+    return;
+  }
+  uint32_t count = stat->count + src->count;
+  float delta = src->mean - stat->mean;
+  float ratio = (float)src->count / count;
+  stat->mean += delta * ratio;
+  stat->m2 += src->m2 + delta * delta * stat->count * ratio;
+  stat->count = count;
+  if(src->min < stat->min) stat->min = src->min;
+  if(src->max > stat->max) stat->max = src->max;
+}
+
+/**
+ * @brief Gets sample variance (divided by `count - 1`) from accumulator.
+ * @param[in] stat Pointer to `STAT_t` accumulator.
+ * @return Variance, `0` for less than two samples.
+ */
+float STAT_Variance(const STAT_t *stat)
+{
+  if(stat->count < 2) return 0.0f;
+  float variance = stat->m2 / (stat->count - 1);
+  return variance > 0.0f ? variance : 0.0f;
+}
+
+/**
+ * @brief Gets sample standard deviation from accumulator.
+ * @param[in] stat Pointer to `STAT_t` accumulator.
+ * @return Standard deviation, `0` for less than two samples.
+ */
+float STAT_StdDev(const STAT_t *stat)
+{
+  return sqrtf(STAT_Variance(stat));
+}
+
+/**
+ * @brief Adds sample to windowed statistics, removing the oldest one when window is full.
+ *   Mean and `m2` are downdated in O(1); `min`/`max` are rescanned only when the removed sample held them.
+ * @param[in,out] window Pointer to `STAT_Window_t` declared with `stat_window_new`.
+ * @param[in] value New sample.
+ */
+void STAT_WindowPush(STAT_Window_t *window, float value)
+{
+  STAT_t *stat = &window->stat;
+  if(stat->count < window->size) {
+    window->data[window->index] = value;
+    window->index = (window->index + 1 == window->size) ? 0 : window->index + 1;
+    STAT_Push(stat, value);
+    return;
+  }
+  float old = window->data[window->index];
+  window->data[window->index] = value;
+  window->index = (window->index + 1 == window->size) ? 0 : window->index + 1;
+  // Replace `old` by `value` with constant count
+  float mean = stat->mean + (value - old) / stat->count;
+  stat->m2 += (value - old) * (value - mean + old - stat->mean);
+  if(stat->m2 < 0.0f) stat->m2 = 0.0f;
+  stat->mean = mean;
+  if(value <= stat->min) stat->min = value;
+  else if(old == stat->min) {
+    stat->min = window->data[0];
+    for(uint16_t i = 1; i < window->size; i++) if(window->data[i] < stat->min) stat->min = window->data[i];
+  }
+  if(value >= stat->max) stat->max = value;
+  else if(old == stat->max) {
+    stat->max = window->data[0];
+    for(uint16_t i = 1; i < window->size; i++) if(window->data[i] > stat->max) stat->max = window->data[i];
+  }
+}
+
+/**
+ * @brief Clears windowed statistics.
+ * @param[out] window Pointer to `STAT_Window_t` structure.
+ */
+void STAT_WindowReset(STAT_Window_t *window)
+{
+  window->index = 0;
+  STAT_Reset(&window->stat);
+}
+
+//------------------------------------------------------------------------------------------------- median
+
+// Running median over a ring window (mediator): max-heap of lower half at negative positions,
+// min-heap of upper half at positive positions, median at position `0` of `root`.
+// Every element knows its heap position, so the sample leaving the window is replaced in place.
+
+#define MEDIAN_MIN_COUNT(median) (((median)->count - 1) / 2)
+#define MEDIAN_MAX_COUNT(median) ((median)->count / 2)
+
+static inline bool MEDIAN_Less(MEDIAN_t *median, int16_t i, int16_t j)
+{
+  return median->data[median->root[i]] < median->data[median->root[j]];
+}
+
+/**
+ * @brief Swaps heap positions `i` and `j` if `root[i] < root[j]`.
+ * @return `true` if elements were swapped.
+ */
+static bool MEDIAN_Exchange(MEDIAN_t *median, int16_t i, int16_t j)
+{
+  if(!MEDIAN_Less(median, i, j)) return false;
+  int16_t t = median->root[i];
+  median->root[i] = median->root[j];
+  median->root[j] = t;
+  median->pos[median->root[i]] = i;
+  median->pos[median->root[j]] = j;
+  return true;
+}
+
+// Restores min-heap order from child position `i` down (`i = 1` also checks the median)
+static void MEDIAN_MinDown(MEDIAN_t *median, int16_t i)
+{
+  for(; i <= MEDIAN_MIN_COUNT(median); i *= 2) {
+    if(i > 1 && i < MEDIAN_MIN_COUNT(median) && MEDIAN_Less(median, i + 1, i)) i++;
+    if(!MEDIAN_Exchange(median, i, i / 2)) break;
+  }
+}
+
+// Restores max-heap order from child position `i` down (`i = -1` also checks the median)
+static void MEDIAN_MaxDown(MEDIAN_t *median, int16_t i)
+{
+  for(; i >= -MEDIAN_MAX_COUNT(median); i *= 2) {
+    if(i < -1 && i > -MEDIAN_MAX_COUNT(median) && MEDIAN_Less(median, i, i - 1)) i--;
+    if(!MEDIAN_Exchange(median, i / 2, i)) break;
+  }
+}
+
+static bool MEDIAN_MinUp(MEDIAN_t *median, int16_t i)
+{
+  while(i > 0 && MEDIAN_Exchange(median, i, i / 2)) i /= 2;
+  return i == 0;
+}
+
+static bool MEDIAN_MaxUp(MEDIAN_t *median, int16_t i)
+{
+  while(i < 0 && MEDIAN_Exchange(median, i / 2, i)) i /= 2;
+  return i == 0;
+}
+
+/**
+ * @brief Empties running median window.
+ * @param[in,out] median Pointer to `MEDIAN_t` declared with `median_new`.
+ */
+void MEDIAN_Reset(MEDIAN_t *median)
+{
+  median->root = median->heap + median->size / 2;
+  median->count = 0;
+  median->index = 0;
+  for(int16_t i = median->size - 1; i >= 0; i--) {
+    median->pos[i] = (int16_t)(((i + 1) / 2) * ((i & 1) ? -1 : 1));
+    median->root[median->pos[i]] = i;
+  }
+  median->init = true;
+}
+
+/**
+ * @brief Adds sample to running median window, replacing the oldest one when window is full.
+ *   O(log n) per sample.
+ * @param[in,out] median Pointer to `MEDIAN_t` declared with `median_new`.
+ * @param[in] value New sample.
+ * @return Median of the samples in window.
+ */
+uint16_t MEDIAN_Push(MEDIAN_t *median, uint16_t value)
+{
+  if(!median->init) MEDIAN_Reset(median);
+  bool fresh = median->count < median->size;
+  int16_t p = median->pos[median->index];
+  uint16_t old = median->data[median->index];
+  median->data[median->index] = value;
+  median->index = (median->index + 1 == median->size) ? 0 : median->index + 1;
+  if(fresh) median->count++;
+  if(p > 0) { // New sample in min-heap
+    if(!fresh && old < value) MEDIAN_MinDown(median, p * 2);
+    else if(MEDIAN_MinUp(median, p)) MEDIAN_MaxDown(median, -1);
+  }
+  else if(p < 0) { // New sample in max-heap
+    if(!fresh && value < old) MEDIAN_MaxDown(median, p * 2);
+    else if(MEDIAN_MaxUp(median, p)) MEDIAN_MinDown(median, 1);
+  }
+  else { // New sample at median
+    if(MEDIAN_MAX_COUNT(median)) MEDIAN_MaxDown(median, -1);
+    if(MEDIAN_MIN_COUNT(median)) MEDIAN_MinDown(median, 1);
+  }
+  return MEDIAN_Value(median);
+}
+
+/**
+ * @brief Gets median of the samples in window (mean of two middle samples for even count).
+ * @param[in] median Pointer to `MEDIAN_t` structure.
+ * @return Current median, `0` if window is empty.
+ */
+uint16_t MEDIAN_Value(const MEDIAN_t *median)
+{
+  if(!median->count) return 0;
+  uint16_t value = median->data[median->root[0]];
+  if(!(median->count & 1)) value = (uint16_t)(((uint32_t)value + median->data[median->root[-1]]) / 2);
+  return value;
+}
+
+/**
+ * @brief Feeds one channel of interleaved samples, e.g. half of ADC DMA buffer.
+ * @param[in,out] median Pointer to `MEDIAN_t` structure.
+ * @param[in] samples Pointer to first sample of the channel.
+ * @param[in] count Number of samples of the channel.
+ * @param[in] stride Distance between consecutive samples of the channel (number of channels).
+ * @return Median after the last sample.
+ */
+uint16_t MEDIAN_PushChunk(MEDIAN_t *median, const uint16_t *samples, uint16_t count, uint8_t stride)
+{
+  for(uint16_t i = 0; i < count; i++, samples += stride) MEDIAN_Push(median, *samples);
+  return MEDIAN_Value(median);
+}
+
+//------------------------------------------------------------------------------------------------- hampel
+
+/**
+ * @brief Hampel filter step: sample further than `k * 1.4826 * MAD` from the window median
+ *   is treated as an outlier and replaced by the median. MAD is tracked with a second
+ *   running median of absolute deviations from the median at the time they arrived.
+ * @param[in,out] hampel Pointer to `HAMPEL_t` declared with `hampel_new`.
+ * @param[in] value New sample.
+ * @return Filtered sample.
+ */
+uint16_t HAMPEL_Push(HAMPEL_t *hampel, uint16_t value)
+{
+  uint16_t med = MEDIAN_Push(&hampel->median, value);
+  uint16_t dev = value > med ? value - med : med - value;
+  uint16_t mad = MEDIAN_Push(&hampel->mad, dev);
+  // 1.4826 (MAD to sigma for normal noise) ~ 379 / 256
+  uint32_t limit = ((uint64_t)mad * hampel->k_q8 * 379) >> 16;
+  if(dev > limit && hampel->median.count == hampel->median.size) {
+    hampel->outliers++;
+    hampel->value = med;
+  }
+  else hampel->value = value;
+  return hampel->value;
+}
+
+/**
+ * @brief Feeds one channel of interleaved samples to Hampel filter, e.g. half of ADC DMA buffer.
+ * @param[in,out] hampel Pointer to `HAMPEL_t` structure.
+ * @param[in] samples Pointer to first sample of the channel.
+ * @param[in] count Number of samples of the channel.
+ * @param[in] stride Distance between consecutive samples of the channel (number of channels).
+ * @return Last filtered sample.
+ */
+uint16_t HAMPEL_PushChunk(HAMPEL_t *hampel, const uint16_t *samples, uint16_t count, uint8_t stride)
+{
+  for(uint16_t i = 0; i < count; i++, samples += stride) HAMPEL_Push(hampel, *samples);
+  return hampel->value;
+}
+
 //-------------------------------------------------------------------------------------------------
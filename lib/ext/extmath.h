@@ -5,6 +5,7 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <stdarg.h>
+#include <string.h>
 #include "extdef.h"
 
 //-------------------------------------------------------------------------------------------------
@@ -21,6 +22,11 @@ float ieee754_unpack(uint32_t value);
 float max_f32_NaN(uint16_t count, ...);
 float min_f32_NaN(uint16_t count, ...);
 
+// Arrays shorter than this are sorted by insertion sort (also introsort partition cutoff)
+#ifndef SORT_INSERTION_LIMIT
+  #define SORT_INSERTION_LIMIT 16
+#endif
+
 void sort_asc_u16(uint16_t *array, uint16_t len);
 void sort_asc_i16(int16_t *array, uint16_t len);
 void sort_desc_u16(uint16_t *array, uint16_t len);
@@ -29,6 +35,11 @@ void sort_asc_u32(uint32_t *array, uint16_t len);
 void sort_asc_i32(int32_t *array, uint16_t len);
 void sort_desc_u32(uint32_t *array, uint16_t len);
 void sort_desc_i32(int32_t *array, uint16_t len);
+void sort_radix_u16(uint16_t *array, uint16_t len, uint16_t *temp);
+
+void select_u16(uint16_t *array, uint16_t len, uint16_t k);
+float avg_rank_u16(uint16_t *array, uint16_t len, uint16_t begin, uint16_t end);
+float trimmed_mean_u16(uint16_t *data, uint16_t n, float lo_frac, float hi_frac);
 
 float avg_u16(const uint16_t *array, uint16_t len);
 float avg_i16(const int16_t *array, uint16_t len);
@@ -66,5 +77,132 @@ int16_t step_limiter_i16(int16_t input, int16_t prev, uint16_t max_delta);
 uint16_t step_limiter_u16(uint16_t input, uint16_t prev, uint16_t max_delta);
 float step_limiter_f32(float input, float prev, float max_delta);
 
+//------------------------------------------------------------------------------------------------- stat
+
+/**
+ * @brief Incremental statistics accumulator (Welford), O(1) per sample without buffering.
+ *   Zero-initialized structure is ready to use.
+ * @param count Number of samples.
+ * @param min Smallest sample.
+ * @param max Largest sample.
+ * @param mean Running mean.
+ * @param m2 Sum of squared deviations from mean, `variance = m2 / (count - 1)`.
+ */
+typedef struct {
+  uint32_t count;
+  float min;
+  float max;
+  float mean;
+  float m2;
+} STAT_t;
+
+/**
+ * @brief Statistics over a sliding window of last `size` samples.
+ * @param data Ring of samples in window (`size` elements). [internal]
+ * @param size Window length (number of samples).
+ * @param index Ring position for next sample. [internal]
+ * @param stat Statistics of samples in window.
+ */
+typedef struct {
+  float *data;
+  uint16_t size;
+  uint16_t index;
+  STAT_t stat;
+} STAT_Window_t;
+
+/**
+ * @brief Helper macro for static windowed statistics declaration.
+ * Example: `stat_window_new(myStat, 100);`
+ * @param Name Name of the `STAT_Window_t` variable.
+ * @param Window Window length (number of samples).
+ */
+#define stat_window_new(Name, Window) \
+  float Name##_data[Window]; \
+  STAT_Window_t Name = { .data = Name##_data, .size = (Window) }
+
+void STAT_Reset(STAT_t *stat);
+void STAT_Push(STAT_t *stat, float value);
+void STAT_Merge(STAT_t *stat, const STAT_t *src);
+float STAT_Variance(const STAT_t *stat);
+float STAT_StdDev(const STAT_t *stat);
+void STAT_WindowPush(STAT_Window_t *window, float value);
+void STAT_WindowReset(STAT_Window_t *window);
+
+//------------------------------------------------------------------------------------------------- median
+
+/**
+ * @brief Running median over a sliding window of `size` samples, O(log n) update.
+ * @param data Ring of samples in window (`size` elements). [internal]
+ * @param pos Heap position of each sample (`size` elements). [internal]
+ * @param heap Heap storage of sample indexes (`size` elements). [internal]
+ * @param size Window length (number of samples).
+ * @param root Middle of `heap`: median at `root[0]`, lower half below, upper half above. [internal]
+ * @param count Number of samples in window. [internal]
+ * @param index Ring position for next sample. [internal]
+ * @param init Set after first `MEDIAN_Reset`. [internal]
+ */
+typedef struct {
+  uint16_t *data;
+  int16_t *pos;
+  int16_t *heap;
+  uint16_t size;
+  int16_t *root;
+  uint16_t count;
+  uint16_t index;
+  bool init;
+} MEDIAN_t;
+
+/**
+ * @brief Helper macro for static running median declaration.
+ * Example: `median_new(myMedian, 31);`
+ * @param Name Name of the `MEDIAN_t` variable.
+ * @param Window Window length (number of samples).
+ */
+#define median_new(Name, Window) \
+  uint16_t Name##_data[Window]; \
+  int16_t Name##_pos[Window]; \
+  int16_t Name##_heap[Window]; \
+  MEDIAN_t Name = { .data = Name##_data, .pos = Name##_pos, .heap = Name##_heap, .size = (Window) }
+
+/**
+ * @brief Hampel outlier filter built on two running medians (signal and absolute deviation).
+ * @param median Running median of samples. [internal]
+ * @param mad Running median of absolute deviations. [internal]
+ * @param k_q8 Outlier threshold in standard deviations, Q8 (`3 * 256` is the usual choice).
+ * @param value Last filtered sample.
+ * @param outliers Number of replaced samples.
+ */
+typedef struct {
+  MEDIAN_t median;
+  MEDIAN_t mad;
+  uint16_t k_q8;
+  uint16_t value;
+  uint32_t outliers;
+} HAMPEL_t;
+
+/**
+ * @brief Helper macro for static Hampel filter declaration.
+ * Example: `hampel_new(myHampel, 15, 3 * 256);`
+ * @param Name Name of the `HAMPEL_t` variable.
+ * @param Window Window length (number of samples).
+ * @param K_Q8 Outlier threshold in standard deviations, Q8.
+ */
+#define hampel_new(Name, Window, K_Q8) \
+  uint16_t Name##_data[2][Window]; \
+  int16_t Name##_pos[2][Window]; \
+  int16_t Name##_heap[2][Window]; \
+  HAMPEL_t Name = { \
+    .median = { .data = Name##_data[0], .pos = Name##_pos[0], .heap = Name##_heap[0], .size = (Window) }, \
+    .mad = { .data = Name##_data[1], .pos = Name##_pos[1], .heap = Name##_heap[1], .size = (Window) }, \
+    .k_q8 = (K_Q8) \
+  }
+
+void MEDIAN_Reset(MEDIAN_t *median);
+uint16_t MEDIAN_Push(MEDIAN_t *median, uint16_t value);
+uint16_t MEDIAN_Value(const MEDIAN_t *median);
+uint16_t MEDIAN_PushChunk(MEDIAN_t *median, const uint16_t *samples, uint16_t count, uint8_t stride);
+uint16_t HAMPEL_Push(HAMPEL_t *hampel, uint16_t value);
+uint16_t HAMPEL_PushChunk(HAMPEL_t *hampel, const uint16_t *samples, uint16_t count, uint8_t stride);
+
 //-------------------------------------------------------------------------------------------------
 #endif
@@ -36,41 +36,170 @@ uint32_t hash_djb2_ci(const char *str)
 
 //-------------------------------------------------------------------------------------------------
 
+static const char Digits[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+static const char DecimalPairs[200] = {
+  '0','0','0','1','0','2','0','3','0','4','0','5','0','6','0','7','0','8','0','9',
+  '1','0','1','1','1','2','1','3','1','4','1','5','1','6','1','7','1','8','1','9',
+  '2','0','2','1','2','2','2','3','2','4','2','5','2','6','2','7','2','8','2','9',
+  '3','0','3','1','3','2','3','3','3','4','3','5','3','6','3','7','3','8','3','9',
+  '4','0','4','1','4','2','4','3','4','4','4','5','4','6','4','7','4','8','4','9',
+  '5','0','5','1','5','2','5','3','5','4','5','5','5','6','5','7','5','8','5','9',
+  '6','0','6','1','6','2','6','3','6','4','6','5','6','6','6','7','6','8','6','9',
+  '7','0','7','1','7','2','7','3','7','4','7','5','7','6','7','7','7','8','7','9',
+  '8','0','8','1','8','2','8','3','8','4','8','5','8','6','8','7','8','8','8','9',
+  '9','0','9','1','9','2','9','3','9','4','9','5','9','6','9','7','9','8','9','9'
+};
+
+static const uint64_t Pow10[20] = {
+  1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull, 100000000ull,
+  1000000000ull, 10000000000ull, 100000000000ull, 1000000000000ull, 10000000000000ull,
+  100000000000000ull, 1000000000000000ull, 10000000000000000ull, 100000000000000000ull,
+  1000000000000000000ull, 10000000000000000000ull
+};
+
+/**
+ * @brief Divide by 100 with multiply and shift (exact for every `uint32_t`).
+ *   Cortex-M0+ has no divide instruction, `/` would be a library call.
+ */
+static inline uint32_t itoa_div100(uint32_t value)
+{
+  return (uint32_t)(((uint64_t)value * 0x51EB851Fu) >> 37);
+}
+
+/**
+ * @brief Write decimal digits of 32-bit value backwards, two digits per step.
+ * @param value Value to write.
+ * @param end Pointer just past the last digit.
+ * @param pad Minimal digit count (leading zeros), used for 9-digit groups.
+ * @return Pointer to first written digit.
+ */
+static char *itoa_dec32(uint32_t value, char *end, uint8_t pad)
+{
+  char *stop = end - pad;
+  while(value >= 100) {
+    uint32_t q = itoa_div100(value);
+    end -= 2;
+    memcpy(end, &DecimalPairs[2 * (value - q * 100)], 2);
+    value = q;
+  }
+  if(value >= 10) {
+    end -= 2;
+    memcpy(end, &DecimalPairs[2 * value], 2);
+  }
+  else *--end = '0' + value;
+  while(end > stop) *--end = '0';
+  return end;
+}
+
+/**
+ * @brief Count digits of `unbr` in `base`.
+ */
+static uint8_t itoa_digits(uint64_t unbr, uint8_t base)
+{
+  uint8_t n = 1;
+  if(base == 10) {
+    while(n < 20 && unbr >= Pow10[n]) n++;
+  }
+  else if(!(base & (base - 1))) {
+    uint8_t shift = 0;
+    while((1u << shift) < base) shift++;
+    for(unbr >>= shift; unbr; unbr >>= shift) n++;
+  }
+  else if(unbr <= UINT32_MAX) {
+    for(uint32_t v = (uint32_t)unbr / base; v; v /= base) n++;
+  }
+  else {
+    for(unbr /= base; unbr; unbr /= base) n++;
+  }
+  return n;
+}
+
+/**
+ * @brief Write digits of `unbr` in `base` backwards, ending just before `end`.
+ */
+static void itoa_write(uint64_t unbr, char *end, uint8_t base)
+{
+  if(base == 10) {
+    // At most two 64-bit divisions, the rest runs in 32 bits
+    while(unbr > UINT32_MAX) {
+      uint64_t q = unbr / 1000000000u;
+      end = itoa_dec32((uint32_t)(unbr - q * 1000000000u), end, 9);
+      unbr = q;
+    }
+    itoa_dec32((uint32_t)unbr, end, 0);
+  }
+  else if(!(base & (base - 1))) {
+    uint8_t shift = 0;
+    while((1u << shift) < base) shift++;
+    uint32_t mask = base - 1;
+    do {
+      *--end = Digits[unbr & mask];
+      unbr >>= shift;
+    } while(unbr);
+  }
+  else {
+    while(unbr > UINT32_MAX) {
+      *--end = Digits[unbr % base];
+      unbr /= base;
+    }
+    uint32_t v = (uint32_t)unbr;
+    do {
+      *--end = Digits[v % base];
+      v /= base;
+    } while(v);
+  }
+}
+
 /**
- * @brief Helper: encode integer digits into reversed string.
- * @param nbr Number to convert (unsigned).
- * @param str Output buffer (digits reversed).
+ * @brief Compute text length produced by `itoa_encode` with the same arguments.
+ * @param nbr Number to convert.
  * @param base Numeric base (2–36).
  * @param sign Include sign (true = signed number, false = unsigned).
  * @param fill_zero Minimal digit count (filled with zeros).
  * @param fill_space Minimal string length (filled with spaces).
+ * @return Number of chars, `0` for invalid base.
+ */
+uint8_t itoa_length(int64_t nbr, uint8_t base, bool sign, uint8_t fill_zero, uint8_t fill_space)
+{
+  if(base < 2 || base > 36) return 0;
+  bool is_negative = sign && nbr < 0;
+  uint64_t unbr = is_negative ? 0 - (uint64_t)nbr : (uint64_t)nbr;
+  uint8_t len = itoa_digits(unbr, base);
+  if(len + is_negative < fill_zero) len = fill_zero - is_negative;
+  len += is_negative;
+  return len < fill_space ? fill_space : len;
+}
+
+/**
+ * @brief Encode integer as text in reading order (not null-terminated).
+ *   Decimal values that fit 32 bits never divide: digits come two at a time from a lookup
+ *   table with reciprocal division by 100. Power-of-two bases use shift and mask.
+ *   Use `itoa_length` to get the length before writing into a bounded buffer.
+ * @param nbr Number to convert.
+ * @param str Output buffer.
+ * @param base Numeric base (2–36).
+ * @param sign Include sign (true = signed number, false = unsigned).
+ * @param fill_zero Minimal digit count (filled with zeros, `-` counts as digit).
+ * @param fill_space Minimal string length (filled with spaces on the left).
  * @return Number of chars written to `str`.
  */
 uint8_t itoa_encode(int64_t nbr, char *str, uint8_t base, bool sign, uint8_t fill_zero, uint8_t fill_space)
 {
-  static const char Digits[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
   if(base < 2 || base > 36) return 0;
-  uint8_t n = 0;
-  bool is_negative = false;
-  uint64_t unbr;
-  // normalize padding parameters
-  if(fill_zero == 0) fill_zero = 1;
-  if(fill_space < fill_zero) fill_space = fill_zero;
-  // handle sign
-  if(sign && nbr < 0) {
-    is_negative = true;
-    unbr = (uint64_t)(-nbr);
-  }
-  else unbr = (uint64_t)nbr;
-  // encode digits in reverse order
-  do {
-    str[n++] = Digits[unbr % base];
-    unbr /= base;
-  } while(unbr > 0);
-  while(n < (fill_zero - (is_negative ? 1 : 0))) str[n++] = '0'; // zero padding (exclude space for '-')
-  if(is_negative)  str[n++] = '-'; // add sign if needed
-  while(n < fill_space) str[n++] = ' '; // space padding to minimum width
-  return n;
+  bool is_negative = sign && nbr < 0;
+  uint64_t unbr = is_negative ? 0 - (uint64_t)nbr : (uint64_t)nbr;
+  uint8_t digits = itoa_digits(unbr, base);
+  uint8_t body = digits;
+  if(body + is_negative < fill_zero) body = fill_zero - is_negative;
+  body += is_negative;
+  uint8_t len = body < fill_space ? fill_space : body;
+  char *p = str;
+  while(p < str + len - body) *p++ = ' ';
+  if(is_negative) *p++ = '-';
+  while(p < str + len - digits) *p++ = '0';
+  itoa_write(unbr, str + len, base);
+  return len;
 }
 
 char StrTempMem[64 + 2]; // Enough for 64-bit binary number (64 bits + sign + '\0')
@@ -87,12 +216,10 @@ char StrTempMem[64 + 2]; // Enough for 64-bit binary number (64 bits + sign + '\
  */
 char *str_from_int(int64_t nbr, uint8_t base, bool sign, uint8_t fill_zero, uint8_t fill_space)
 {
-  uint8_t len = itoa_encode(nbr, StrTempMem, base, sign, fill_zero, fill_space);
+  uint8_t len = itoa_length(nbr, base, sign, fill_zero, fill_space);
   char *string = heap_new(len + 1);
   if(!string) return NULL;
-  for(uint8_t i = 0; i < len; i++) {
-    string[i] = StrTempMem[len - 1 - i];
-  }
+  itoa_encode(nbr, string, base, sign, fill_zero, fill_space);
   string[len] = '\0';
   return string;
 }
@@ -1127,4 +1254,40 @@ int str_explode(char ***arr_ptr, const char *str, char delimiter)
   return count;
 }
 
+/**
+ * Split string into tokens separated by whitespace, in place (no allocation, no copy).
+ * Token ends are overwritten with '\0' and `argv` points into `str`.
+ * Text in double or single quotes may contain whitespace; quotes are removed
+ * and quoted text is not case-mapped.
+ * @param str Input string (null-terminated, modified).
+ * @param argv Output array of token pointers.
+ * @param limit Capacity of `argv`, text after the last token that fits is ignored.
+ * @param map Case table (`LowerCase`, `UpperCase`) applied on the fly, or NULL.
+ * @return Number of tokens.
+ */
+uint16_t str_tokenize(char *str, char **argv, uint16_t limit, const char *map)
+{
+  uint16_t argc = 0;
+  char *src = str;
+  while(argc < limit) {
+    while(*src == ' ' || *src == '\t' || *src == '\r' || *src == '\n') src++;
+    if(!*src) break;
+    char *dst = src;
+    argv[argc++] = dst;
+    char quote = 0;
+    while(*src) {
+      char c = *src++;
+      if(quote) {
+        if(c == quote) quote = 0;
+        else *dst++ = c;
+      }
+      else if(c == '"' || c == '\'') quote = c;
+      else if(c == ' ' || c == '\t' || c == '\r' || c == '\n') break;
+      else *dst++ = map ? map[(uint8_t)c] : c;
+    }
+    *dst = '\0'; // Never past `src`, so unread text stays intact
+  }
+  return argc;
+}
+
 //-------------------------------------------------------------------------------------------------
@@ -22,6 +22,7 @@ extern const char UpperCase[];
 uint32_t hash_djb2(const char *str);
 uint32_t hash_djb2_ci(const char *str);
 
+uint8_t itoa_length(int64_t nbr, uint8_t base, bool sign, uint8_t fill_zero, uint8_t fill_space);
 uint8_t itoa_encode(int64_t nbr, char *str, uint8_t base, bool sign, uint8_t fill_zero, uint8_t fill_space);
 char *str_from_int(int64_t nbr, uint8_t base, bool sign, uint8_t fill_zero, uint8_t fill_space);
 bool str_is_u16(const char *str);
@@ -65,6 +66,7 @@ char *str_replace_chars(const char *str, const char *pattern, char replacement);
 char *str_replace(const char *str, const char *pattern, const char *replacement);
 char *str_split(const char *str, char delimiter, int index);
 int str_explode(char ***arr_ptr, const char *str, char delimiter);
+uint16_t str_tokenize(char *str, char **argv, uint16_t limit, const char *map);
 
 //-------------------------------------------------------------------------------------------------
 #endif
@@ -1,5 +1,7 @@
 #include "file.h"
-#include "dbg.h"
+#ifdef OpenCPLC
+  #include "dbg.h"
+#endif
 
 //-------------------------------------------------------------------------------------------------
 
@@ -259,22 +261,85 @@ int32_t FILE_Bool(FILE_t *file, bool value)
 int32_t FILE_Int(FILE_t *file, int64_t nbr, uint8_t base, bool sign, uint8_t fill_zero, uint8_t fill_space)
 {
   if(file->lock) return 0;
-  int32_t len = (int32_t)itoa_encode(nbr, StrTempMem, base, sign, fill_zero, fill_space);
+  int32_t len = (int32_t)itoa_length(nbr, base, sign, fill_zero, fill_space);
   if(file->size + len > file->limit) return 0;
-  int32_t n = len;
-  while(n) {
-    n--;
-    file->buffer[file->size++] = StrTempMem[n];
-  }
+  itoa_encode(nbr, (char *)&file->buffer[file->size], base, sign, fill_zero, fill_space);
+  file->size += len;
   return len;
 }
 
+static const uint32_t FilePow10[10] = {
+  1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+/**
+ * @brief Write decimal digits of `|nbr| * 10^accuracy` correctly rounded (half to even, like printf).
+ *   Float is split into 24-bit mantissa and binary exponent, scaled once by integer power of ten
+ *   and shifted, so no soft-float operation is used. Values `>= 2^64` take slow multi-word path.
+ * @param[in] nbr Finite float number.
+ * @param[in] accuracy Number of digits after decimal point (max `9`).
+ * @param[out] str Output buffer, at least `49` bytes (not null-terminated).
+ * @return Number of digits written, at least `accuracy + 1`.
+ */
+static uint8_t FILE_FloatDigits(float nbr, uint8_t accuracy, char *str)
+{
+  uint32_t bits;
+  memcpy(&bits, &nbr, sizeof(bits));
+  int32_t exp = (bits >> 23) & 0xFF;
+  uint32_t mantissa = bits & 0x7FFFFF;
+  if(exp) mantissa |= 0x800000;
+  else exp = 1; // denormal
+  exp -= 150; // nbr = mantissa * 2^exp
+  if(exp < 0) {
+    uint32_t shift = (uint32_t)-exp;
+    uint64_t scaled = (uint64_t)mantissa * FilePow10[accuracy]; // < 2^54
+    uint64_t value = 0;
+    if(shift < 64) {
+      value = scaled >> shift;
+      uint64_t rest = scaled - (value << shift);
+      uint64_t half = (uint64_t)1 << (shift - 1);
+      if(rest > half || (rest == half && (value & 1))) value++;
+    }
+    return itoa_encode((int64_t)value, str, 10, false, accuracy + 1, 0);
+  }
+  uint8_t len;
+  if(exp < 40) {
+    len = itoa_encode((int64_t)((uint64_t)mantissa << exp), str, 10, false, 1, 0);
+  }
+  else {
+    // Integer up to 2^128 in 32-bit words, converted in 9-digit chunks
+    uint32_t word[5] = { 0 };
+    uint64_t shifted = (uint64_t)mantissa << (exp & 31);
+    word[exp >> 5] = (uint32_t)shifted;
+    word[(exp >> 5) + 1] = (uint32_t)(shifted >> 32);
+    uint32_t chunk[5];
+    uint8_t count = 0;
+    uint8_t top = 4;
+    while(top && !word[top]) top--;
+    while(top || word[0]) {
+      uint64_t rest = 0;
+      for(int8_t i = top; i >= 0; i--) {
+        uint64_t cur = (rest << 32) | word[i];
+        word[i] = (uint32_t)(cur / 1000000000);
+        rest = cur % 1000000000;
+      }
+      chunk[count++] = (uint32_t)rest;
+      while(top && !word[top]) top--;
+    }
+    len = itoa_encode(chunk[--count], str, 10, false, 1, 0);
+    while(count) len += itoa_encode(chunk[--count], str + len, 10, false, 9, 0);
+  }
+  memset(str + len, '0', accuracy);
+  return len + accuracy;
+}
+
 /**
  * @brief Append float value to file buffer.
- * Supports NaN, Inf, decimal point, zero/space padding.
+ * Supports NaN, Inf, decimal point, space padding. Value is rounded like `printf("%.*f")`,
+ * including `-0.00` for small negative numbers.
  * @param[in,out] file Pointer to `FILE_t` structure
  * @param[in] nbr Float number
- * @param[in] accuracy Number of digits after decimal point
+ * @param[in] accuracy Number of digits after decimal point (max `9`, larger is clamped)
  * @param[in] fill_space Minimum field width (space padded)
  * @return Number of bytes written, `0` on lock/error
  */
@@ -314,18 +379,25 @@ int32_t FILE_Float(FILE_t *file, float nbr, uint8_t accuracy, uint8_t fill_space
       return FILE_String(file, nan);
     }
   #endif
-  // move '.'
-  for(uint16_t i = 0; i < accuracy; i++) nbr *= 10;
-  if(!fill_space) fill_space = 1;
-  int32_t length = (int32_t)itoa_encode((int32_t)nbr, StrTempMem, 10, true, nbr < 0 ? accuracy + 2 : accuracy + 1, fill_space - 1);
-  int32_t n = length + (accuracy ? 1 : 0);
+  if(accuracy > 9) accuracy = 9;
+  char digits[49];
+  int32_t length = FILE_FloatDigits(nbr, accuracy, digits);
+  int32_t integer = length - accuracy;
+  bool negative = signbit(nbr);
+  int32_t n = negative + length + (accuracy ? 1 : 0);
+  if(n < fill_space) n = fill_space;
   if(file->size + n > file->limit) return 0;
-  while(length) {
-    if(accuracy && length == accuracy) {
-      file->buffer[file->size++] = '.';
-    }
-    file->buffer[file->size++] = StrTempMem[--length];
+  uint8_t *p = &file->buffer[file->size];
+  uint8_t *end = p + n;
+  while(p < end - length - negative - (accuracy ? 1 : 0)) *p++ = ' ';
+  if(negative) *p++ = '-';
+  memcpy(p, digits, integer);
+  p += integer;
+  if(accuracy) {
+    *p++ = '.';
+    memcpy(p, digits + integer, accuracy);
   }
+  file->size += n;
   return n;
 }
 
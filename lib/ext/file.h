@@ -91,6 +91,7 @@ const uint8_t *FILE_Struct_Peek(FILE_t *file, uint16_t index);
 status_t FILE_Offset_Set(FILE_t *file, uint16_t offset);
 status_t FILE_Offset_Rst(FILE_t *file);
 
+#ifdef OpenCPLC
 status_t FILE_Flash_Save(FILE_t *file);
 status_t FILE_Flash_Load(FILE_t *file);
 int32_t FILE_Date(FILE_t *file, RTC_Datetime_t *datetime);
@@ -102,6 +103,7 @@ int32_t FILE_AlarmTime(FILE_t *file, RTC_Alarm_t *alarm);
 int32_t FILE_Alarm(FILE_t *file, RTC_Alarm_t *alarm);
 int32_t FILE_CrcAppend(FILE_t *file, const CRC_t *crc);
 bool FILE_CrcError(FILE_t *file, const CRC_t *crc);
+#endif
 
 //-------------------------------------------------------------------------------------------------
 #endif
@@ -1,45 +1,305 @@
 #include "queue.h"
 
+/**
+ * @brief Swap two elements, word by word when both are 4-byte aligned and sized.
+ * @param[in,out] a Pointer to first element.
+ * @param[in,out] b Pointer to second element.
+ * @param[in] n Element size in bytes.
+ */
 static void QUEUE_Swap(void *a, void *b, uint16_t n)
 {
+  if(!(((uintptr_t)a | (uintptr_t)b | n) & 3)) {
+    uint32_t *wa = (uint32_t *)a, *wb = (uint32_t *)b;
+    for(uint32_t i = 0; i < (uint32_t)n / 4; i++) {
+      uint32_t t = wa[i]; wa[i] = wb[i]; wb[i] = t;
+    }
+    return;
+  }
   uint8_t *pa = (uint8_t *)a, *pb = (uint8_t *)b;
   for(uint32_t i = 0; i < n; i++) {
     uint8_t t = pa[i]; pa[i] = pb[i]; pb[i] = t;
   }
 }
 
+static inline void *QUEUE_Slot(const QUEUE_t *queue, uint16_t idx)
+{
+  return (char *)queue->buffer + (uint32_t)idx * queue->struct_size;
+}
+
+// Ring index step by compare instead of `%`: Cortex-M0+ has no divide instruction
+static inline uint16_t QUEUE_Next(const QUEUE_t *queue, uint16_t idx)
+{
+  return (uint16_t)(idx + 1 == queue->capacity ? 0 : idx + 1);
+}
+
+static inline uint16_t QUEUE_Prev(const QUEUE_t *queue, uint16_t idx)
+{
+  return (uint16_t)(idx ? idx - 1 : queue->capacity - 1);
+}
+
+static inline bool QUEUE_IsHeap(const QUEUE_t *queue)
+{
+  return queue->heap && queue->Compare;
+}
+
+//------------------------------------------------------------------------------------------------- index
+
 /**
- * @brief Push element to queue if not full, skip if duplicate when unique enabled.
+ * @brief Check if the hash index is in use for uniqueness filter.
+ *   Byte-wise hash is consistent only with byte-wise equality, so a custom `Equal` requires `Hash`.
+ */
+static inline bool QUEUE_IsIndexed(const QUEUE_t *queue)
+{
+  return queue->unique && queue->index && queue->index_size && (queue->Hash || !queue->Equal);
+}
+
+/**
+ * @brief Home position of element in hash index.
+ * @param[in] queue Pointer to `QUEUE_t` control structure.
+ * @param[in] element Pointer to element.
+ * @return Index entry where probing starts.
+ */
+static uint16_t QUEUE_IndexHome(const QUEUE_t *queue, const void *element)
+{
+  uint32_t hash;
+  if(queue->Hash) hash = queue->Hash(element);
+  else {
+    const uint8_t *p = (const uint8_t *)element;
+    hash = 2166136261u;
+    for(uint16_t i = 0; i < queue->struct_size; i++) hash = (hash ^ p[i]) * 16777619u;
+  }
+  hash ^= hash >> 16;
+  return (uint16_t)(hash & (queue->index_size - 1));
+}
+
+/**
+ * @brief Find index entry that points to buffer slot `idx`.
+ * @param[in] queue Pointer to `QUEUE_t` control structure.
+ * @param[in] idx Buffer slot of indexed element.
+ * @return Position of the entry in `index`.
+ */
+static uint16_t QUEUE_IndexFind(const QUEUE_t *queue, uint16_t idx)
+{
+  uint16_t mask = queue->index_size - 1;
+  uint16_t pos = QUEUE_IndexHome(queue, QUEUE_Slot(queue, idx));
+  while(queue->index[pos] != idx + 1) pos = (pos + 1) & mask;
+  return pos;
+}
+
+/**
+ * @brief Add element stored in buffer slot `idx` to hash index.
  * @param[in,out] queue Pointer to `QUEUE_t` control structure.
- * @param[in] element Pointer to element to add.
- * @return `true` if element was added, `false` if queue is full or duplicate.
+ * @param[in] idx Buffer slot of element.
  */
-bool QUEUE_Push(QUEUE_t *queue, const void *element)
+static void QUEUE_IndexInsert(QUEUE_t *queue, uint16_t idx)
 {
-  if(queue->count == queue->capacity) return false;
-  if(queue->unique) {
-    for(uint16_t i = 0; i < queue->count; i++) {
-      uint16_t idx = (queue->head + i) % queue->capacity;
-      const void *item = (const char *)queue->buffer + (uint32_t)idx * queue->struct_size;
+  uint16_t mask = queue->index_size - 1;
+  uint16_t pos = QUEUE_IndexHome(queue, QUEUE_Slot(queue, idx));
+  while(queue->index[pos]) pos = (pos + 1) & mask;
+  queue->index[pos] = idx + 1;
+}
+
+/**
+ * @brief Remove element stored in buffer slot `idx` from hash index.
+ *   Uses backward-shift deletion, so linear probe chains stay intact without tombstones.
+ * @param[in,out] queue Pointer to `QUEUE_t` control structure.
+ * @param[in] idx Buffer slot of element.
+ */
+static void QUEUE_IndexRemove(QUEUE_t *queue, uint16_t idx)
+{
+  uint16_t mask = queue->index_size - 1;
+  uint16_t hole = QUEUE_IndexFind(queue, idx);
+  uint16_t pos = hole;
+  while(1) {
+    pos = (pos + 1) & mask;
+    if(!queue->index[pos]) break;
+    uint16_t home = QUEUE_IndexHome(queue, QUEUE_Slot(queue, queue->index[pos] - 1));
+    // Entry may fill the hole only if the hole lies on its probe path `home -> pos`
+    if(((pos - home) & mask) >= ((pos - hole) & mask)) {
+      queue->index[hole] = queue->index[pos];
+      hole = pos;
+    }
+  }
+  queue->index[hole] = 0;
+}
+
+/**
+ * @brief Swap elements in buffer slots `a` and `b`, keeping hash index in sync.
+ * @param[in,out] queue Pointer to `QUEUE_t` control structure.
+ * @param[in] a First buffer slot.
+ * @param[in] b Second buffer slot.
+ */
+static void QUEUE_Exchange(QUEUE_t *queue, uint16_t a, uint16_t b)
+{
+  if(QUEUE_IsIndexed(queue)) {
+    uint16_t pa = QUEUE_IndexFind(queue, a);
+    uint16_t pb = QUEUE_IndexFind(queue, b);
+    queue->index[pa] = b + 1;
+    queue->index[pb] = a + 1;
+  }
+  QUEUE_Swap(QUEUE_Slot(queue, a), QUEUE_Slot(queue, b), queue->struct_size);
+}
+
+//------------------------------------------------------------------------------------------------- heap
+
+/**
+ * @brief Heap order: `true` if element `a` has to be popped before element `b`.
+ *   Largest first, smallest first when `invert` is set.
+ */
+static inline bool QUEUE_Before(const QUEUE_t *queue, const void *a, const void *b)
+{
+  int32_t cmp = queue->Compare(a, b);
+  return queue->invert ? cmp < 0 : cmp > 0;
+}
+
+/**
+ * @brief Restore heap order by moving element at `idx` towards the root.
+ * @param[in,out] queue Pointer to `QUEUE_t` control structure.
+ * @param[in] idx Index of newly placed element.
+ */
+static void QUEUE_HeapUp(QUEUE_t *queue, uint16_t idx)
+{
+  while(idx) {
+    uint16_t parent = (uint16_t)((idx - 1) >> 1);
+    if(!QUEUE_Before(queue, QUEUE_Slot(queue, idx), QUEUE_Slot(queue, parent))) break;
+    QUEUE_Exchange(queue, parent, idx);
+    idx = parent;
+  }
+}
+
+/**
+ * @brief Restore heap order by moving root element towards the leaves.
+ * @param[in,out] queue Pointer to `QUEUE_t` control structure.
+ */
+static void QUEUE_HeapDown(QUEUE_t *queue)
+{
+  uint16_t idx = 0;
+  while(1) {
+    uint32_t child = 2 * (uint32_t)idx + 1;
+    if(child >= queue->count) break;
+    if(child + 1 < queue->count && QUEUE_Before(queue, QUEUE_Slot(queue, child + 1), QUEUE_Slot(queue, child))) child++;
+    if(!QUEUE_Before(queue, QUEUE_Slot(queue, (uint16_t)child), QUEUE_Slot(queue, idx))) break;
+    QUEUE_Exchange(queue, idx, (uint16_t)child);
+    idx = (uint16_t)child;
+  }
+}
+
+/**
+ * @brief Remove heap root: last element takes its place and sinks down.
+ * @param[in,out] queue Pointer to `QUEUE_t` control structure.
+ */
+static void QUEUE_HeapRemove(QUEUE_t *queue)
+{
+  bool indexed = QUEUE_IsIndexed(queue);
+  if(indexed) QUEUE_IndexRemove(queue, 0);
+  queue->count--;
+  queue->tail = queue->count;
+  if(queue->count) {
+    if(indexed) queue->index[QUEUE_IndexFind(queue, queue->count)] = 1;
+    memcpy(QUEUE_Slot(queue, 0), QUEUE_Slot(queue, queue->count), queue->struct_size);
+    QUEUE_HeapDown(queue);
+  }
+}
+
+//------------------------------------------------------------------------------------------------- queue
+
+/**
+ * @brief Check whether element already exists in queue.
+ * @param[in] queue Pointer to `QUEUE_t` control structure.
+ * @param[in] element Pointer to element to look for.
+ * @return `true` if an equal element is already queued.
+ */
+static bool QUEUE_Contains(const QUEUE_t *queue, const void *element)
+{
+  if(QUEUE_IsIndexed(queue)) {
+    uint16_t mask = queue->index_size - 1;
+    for(uint16_t pos = QUEUE_IndexHome(queue, element); queue->index[pos]; pos = (pos + 1) & mask) {
+      const void *item = QUEUE_Slot(queue, queue->index[pos] - 1);
       bool same = queue->Equal ? queue->Equal(item, element) : memcmp(item, element, queue->struct_size) == 0;
-      if(same) return false;
+      if(same) return true;
     }
+    return false;
+  }
+  uint16_t idx = queue->head;
+  for(uint16_t i = 0; i < queue->count; i++) {
+    const void *item = QUEUE_Slot(queue, idx);
+    bool same = queue->Equal ? queue->Equal(item, element) : memcmp(item, element, queue->struct_size) == 0;
+    if(same) return true;
+    idx = QUEUE_Next(queue, idx);
+  }
+  return false;
+}
+
+/**
+ * @brief Append element already written to `tail` slot: advance indices and keep order.
+ * @param[in,out] queue Pointer to `QUEUE_t` control structure.
+ */
+static void QUEUE_Append(QUEUE_t *queue)
+{
+  if(QUEUE_IsIndexed(queue)) QUEUE_IndexInsert(queue, queue->tail);
+  if(QUEUE_IsHeap(queue)) {
+    // Heap mode keeps elements in `[0, count)`: `head` stays `0` and `tail` equals `count`
+    QUEUE_HeapUp(queue, queue->count);
+    queue->count++;
+    queue->tail = queue->count;
+    return;
   }
-  void *dest = (char *)queue->buffer + (uint32_t)queue->tail * queue->struct_size;
-  memcpy(dest, element, queue->struct_size);
   uint16_t cur = queue->tail;
-  queue->tail = (queue->tail + 1) % queue->capacity;
+  queue->tail = QUEUE_Next(queue, queue->tail);
   queue->count++;
   if(queue->Compare) {
     while(cur != queue->head) {
-      uint16_t prev = (uint16_t)((cur + queue->capacity - 1) % queue->capacity);
-      void *a = (char *)queue->buffer + (uint32_t)prev * queue->struct_size;
-      void *b = (char *)queue->buffer + (uint32_t)cur * queue->struct_size;
-      if(queue->Compare(a, b) >= 0) break;
-      QUEUE_Swap(a, b, queue->struct_size);
+      uint16_t prev = QUEUE_Prev(queue, cur);
+      if(queue->Compare(QUEUE_Slot(queue, prev), QUEUE_Slot(queue, cur)) >= 0) break;
+      QUEUE_Exchange(queue, prev, cur);
       cur = prev;
     }
   }
+}
+
+/**
+ * @brief Push element to queue if not full, skip if duplicate when unique enabled.
+ * @param[in,out] queue Pointer to `QUEUE_t` control structure.
+ * @param[in] element Pointer to element to add.
+ * @return `true` if element was added, `false` if queue is full or duplicate.
+ */
+bool QUEUE_Push(QUEUE_t *queue, const void *element)
+{
+  if(queue->count == queue->capacity) return false;
+  if(queue->unique && QUEUE_Contains(queue, element)) return false;
+  void *dest = (char *)queue->buffer + (uint32_t)queue->tail * queue->struct_size;
+  memcpy(dest, element, queue->struct_size);
+  QUEUE_Append(queue);
+  return true;
+}
+
+/**
+ * @brief Reserve the next free slot for in-place writing (copy-free push).
+ *   Element is not visible to `Pop`/`Peek` until `QUEUE_Commit` is called.
+ *   Only one reservation may be open at a time.
+ * @param[in] queue Pointer to `QUEUE_t` control structure.
+ * @return Pointer to slot memory (`struct_size` bytes), `NULL` if queue is full.
+ */
+void *QUEUE_Reserve(QUEUE_t *queue)
+{
+  if(queue->count == queue->capacity) return NULL;
+  return (char *)queue->buffer + (uint32_t)queue->tail * queue->struct_size;
+}
+
+/**
+ * @brief Publish slot previously returned by `QUEUE_Reserve`.
+ *   Uniqueness filter and `Compare` ordering are applied here, as in `QUEUE_Push`.
+ * @param[in,out] queue Pointer to `QUEUE_t` control structure.
+ * @return `true` if element was added, `false` if queue is full or duplicate (slot is dropped).
+ */
+bool QUEUE_Commit(QUEUE_t *queue)
+{
+  if(queue->count == queue->capacity) return false;
+  if(queue->unique) {
+    const void *slot = (const char *)queue->buffer + (uint32_t)queue->tail * queue->struct_size;
+    if(QUEUE_Contains(queue, slot)) return false;
+  }
+  QUEUE_Append(queue);
   return true;
 }
 
@@ -54,19 +314,8 @@ bool QUEUE_Push(QUEUE_t *queue, const void *element)
 bool QUEUE_Pop(QUEUE_t *queue, void *element)
 {
   if(queue->count == 0) return false;
-  if(queue->invert) {
-    uint16_t idx = (uint16_t)((queue->tail + queue->capacity - 1) % queue->capacity);
-    const void *src = (const char *)queue->buffer + (uint32_t)idx * queue->struct_size;
-    memcpy(element, src, queue->struct_size);
-    queue->tail = idx;
-  }
-  else {
-    const void *src = (const char *)queue->buffer + (uint32_t)queue->head * queue->struct_size;
-    memcpy(element, src, queue->struct_size);
-    queue->head = (uint16_t)((queue->head + 1) % queue->capacity);
-  }
-  queue->count--;
-  return true;
+  memcpy(element, QUEUE_Front(queue), queue->struct_size);
+  return QUEUE_Drop(queue);
 }
 
 /**
@@ -80,18 +329,102 @@ bool QUEUE_Pop(QUEUE_t *queue, void *element)
 bool QUEUE_Peek(const QUEUE_t *queue, void *element)
 {
   if(queue->count == 0) return false;
-  if(queue->invert) {
-    uint16_t idx = (uint16_t)((queue->tail + queue->capacity - 1) % queue->capacity);
-    const void *src = (const char *)queue->buffer + (uint32_t)idx * queue->struct_size;
-    memcpy(element, src, queue->struct_size);
-  }
-  else {
-    const void *src = (const char *)queue->buffer + (uint32_t)queue->head * queue->struct_size;
-    memcpy(element, src, queue->struct_size);
+  memcpy(element, QUEUE_Front(queue), queue->struct_size);
+  return true;
+}
+
+/**
+ * @brief Access element that `Pop` would return, without copying it.
+ *   Pointer stays valid until the element is dropped or the queue is modified by `Push` with `Compare`.
+ *   In `heap` mode the front element is always at the start of `buffer`.
+ * @param[in] queue Pointer to `QUEUE_t` control structure.
+ * @return Pointer to element memory, `NULL` if `queue` is empty.
+ */
+void *QUEUE_Front(const QUEUE_t *queue)
+{
+  if(queue->count == 0) return NULL;
+  if(QUEUE_IsHeap(queue)) return QUEUE_Slot(queue, 0);
+  uint16_t idx = queue->invert ? QUEUE_Prev(queue, queue->tail) : queue->head;
+  return (char *)queue->buffer + (uint32_t)idx * queue->struct_size;
+}
+
+/**
+ * @brief Remove element that `Pop` would return, without copying it.
+ * @param[in,out] queue Pointer to `QUEUE_t` control structure.
+ * @return `true` if element removed, `false` if queue empty.
+ */
+bool QUEUE_Drop(QUEUE_t *queue)
+{
+  if(queue->count == 0) return false;
+  if(QUEUE_IsHeap(queue)) {
+    QUEUE_HeapRemove(queue);
+    return true;
   }
+  uint16_t idx = queue->invert ? QUEUE_Prev(queue, queue->tail) : queue->head;
+  if(QUEUE_IsIndexed(queue)) QUEUE_IndexRemove(queue, idx);
+  if(queue->invert) queue->tail = idx;
+  else queue->head = QUEUE_Next(queue, queue->head);
+  queue->count--;
   return true;
 }
 
+/**
+ * @brief Push up to `n` elements stored contiguously in `elements`.
+ *   Plain FIFO/LIFO queue copies the data with at most two `memcpy` calls,
+ *   `unique` and `Compare` modes push one element at a time.
+ * @param[in,out] queue Pointer to `QUEUE_t` control structure.
+ * @param[in] elements Pointer to first element.
+ * @param[in] n Number of elements.
+ * @return Number of elements added (stops when queue is full).
+ */
+uint16_t QUEUE_PushN(QUEUE_t *queue, const void *elements, uint16_t n)
+{
+  const uint8_t *src = (const uint8_t *)elements;
+  if(queue->unique || queue->Compare) {
+    uint16_t added = 0;
+    for(uint16_t i = 0; i < n && queue->count < queue->capacity; i++) {
+      if(QUEUE_Push(queue, src + (uint32_t)i * queue->struct_size)) added++;
+    }
+    return added;
+  }
+  uint16_t space = queue->capacity - queue->count;
+  if(n > space) n = space;
+  uint16_t first = queue->capacity - queue->tail;
+  if(first > n) first = n;
+  memcpy(QUEUE_Slot(queue, queue->tail), src, (uint32_t)first * queue->struct_size);
+  memcpy(queue->buffer, src + (uint32_t)first * queue->struct_size, (uint32_t)(n - first) * queue->struct_size);
+  queue->tail = (uint16_t)(n - first ? n - first : queue->tail + n);
+  if(queue->tail == queue->capacity) queue->tail = 0;
+  queue->count += n;
+  return n;
+}
+
+/**
+ * @brief Pop up to `n` elements into contiguous memory, in the order `QUEUE_Pop` would return them.
+ *   Plain FIFO queue copies the data with at most two `memcpy` calls, other modes pop one at a time.
+ * @param[in,out] queue Pointer to `QUEUE_t` control structure.
+ * @param[out] elements Pointer to memory for `n` elements.
+ * @param[in] n Max number of elements.
+ * @return Number of elements copied.
+ */
+uint16_t QUEUE_PopN(QUEUE_t *queue, void *elements, uint16_t n)
+{
+  uint8_t *dest = (uint8_t *)elements;
+  if(n > queue->count) n = queue->count;
+  if(queue->invert || queue->Compare || QUEUE_IsIndexed(queue)) {
+    for(uint16_t i = 0; i < n; i++) QUEUE_Pop(queue, dest + (uint32_t)i * queue->struct_size);
+    return n;
+  }
+  uint16_t first = queue->capacity - queue->head;
+  if(first > n) first = n;
+  memcpy(dest, QUEUE_Slot(queue, queue->head), (uint32_t)first * queue->struct_size);
+  memcpy(dest + (uint32_t)first * queue->struct_size, queue->buffer, (uint32_t)(n - first) * queue->struct_size);
+  queue->head = (uint16_t)(n - first ? n - first : queue->head + n);
+  if(queue->head == queue->capacity) queue->head = 0;
+  queue->count -= n;
+  return n;
+}
+
 /**
  * @brief Check if queue is empty.
  * @param[in] queue Pointer to `QUEUE_t` control structure.
@@ -123,11 +456,12 @@ uint16_t QUEUE_Count(const QUEUE_t *queue)
 }
 
 /**
- * @brief Clear queue to an empty state (buffer contents are left intact).
+ * @brief Clear queue to an empty state (buffer contents are left intact, hash index is zeroed).
  * @param[in,out] queue Pointer to `QUEUE_t` control structure.
  */
 void QUEUE_Clear(QUEUE_t *queue)
 {
+  if(queue->index) memset(queue->index, 0, (uint32_t)queue->index_size * sizeof(uint16_t));
   queue->head = 0;
   queue->tail = 0;
   queue->count = 0;
@@ -15,10 +15,18 @@
  * @param[in] capacity Max number of elements (not bytes).
  * @param[in] unique When `true`, duplicate elements are rejected.
  * @param[in] invert If `true`, pop/peek from tail instead of head.
+ * @param[in] heap When `true` and `Compare` is set, elements are kept as a binary heap:
+ *   O(log n) push/pop instead of O(n) insertion sort. Pop order is the same, but elements
+ *   with equal keys are not returned in insertion order.
  * @param[in] Equal Optional equality predicate; returns `true` if `a` and `b` represent the same element.
  *   If `NULL`, uniqueness falls back to byte-wise comparison of the entire element.
  * @param[in] Compare Optional comparison function; returns `<0` if `a<b`, `0` if `a==b`, `>0` if `a>b`.
  *   If `NULL`, the queue behaves as a regular FIFO/LIFO (no sorting).
+ * @param[in] index Optional hash index storage for `unique` mode (`index_size` entries, zero-initialized).
+ *   Turns the duplicate scan into O(1) average lookup. Used only when `Hash` is set or `Equal` is `NULL`.
+ * @param[in] index_size Number of `index` entries, power of two larger than `capacity` (2x recommended).
+ * @param[in] Hash Optional key hash; has to agree with `Equal` (equal elements give equal hash).
+ *   If `NULL`, the whole element is hashed byte-wise (FNV-1a).
  * @param head Index of oldest element. [internal]
  * @param tail Index of next free slot. [internal]
  * @param count Current number of elements. [internal]
@@ -29,8 +37,12 @@ typedef struct {
   uint16_t capacity;
   bool unique;
   bool invert;
+  bool heap;
   bool (*Equal)(const void *a, const void *b);
   int32_t (*Compare)(const void *a, const void *b);
+  uint16_t *index;
+  uint16_t index_size;
+  uint32_t (*Hash)(const void *element);
   uint16_t head;
   uint16_t tail;
   uint16_t count;
@@ -41,6 +53,12 @@ typedef struct {
 bool QUEUE_Push(QUEUE_t *queue, const void *element);
 bool QUEUE_Pop(QUEUE_t *queue, void *element);
 bool QUEUE_Peek(const QUEUE_t *queue, void *element);
+void *QUEUE_Reserve(QUEUE_t *queue);
+bool QUEUE_Commit(QUEUE_t *queue);
+void *QUEUE_Front(const QUEUE_t *queue);
+bool QUEUE_Drop(QUEUE_t *queue);
+uint16_t QUEUE_PushN(QUEUE_t *queue, const void *elements, uint16_t n);
+uint16_t QUEUE_PopN(QUEUE_t *queue, void *elements, uint16_t n);
 bool QUEUE_IsEmpty(const QUEUE_t *queue);
 bool QUEUE_IsFull(const QUEUE_t *queue);
 uint16_t QUEUE_Count(const QUEUE_t *queue);
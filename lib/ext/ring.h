@@ -2,17 +2,34 @@
 #define RING_H_
 
 #include <stdint.h>
+#include <string.h>
 
 /**
- * @brief Helper macro for static ring16_t declaration.
- * Example: `ring16_new(myRing, 16);`
- * Declares: `uint16_t myRing_storage[16]; ring16_t myRing = { myRing_storage, 16, 0, 0, 0 };`
- * @param Name Name of the ring16_t variable.
+ * @brief Advance ring index by `n` positions without division.
+ *   Valid for `idx < limit` and `n <= limit`, which holds for every ring operation.
+ * @param idx Current index.
+ * @param n Number of positions to advance.
+ * @param limit Ring capacity.
+ * @return Wrapped index in range `[0, limit)`.
+ */
+static inline uint16_t ring_wrap(uint16_t idx, uint16_t n, uint16_t limit)
+{
+  uint32_t next = (uint32_t)idx + n;
+  return (uint16_t)(next >= limit ? next - limit : next);
+}
+
+/**
+ * @brief Helper macro for static ring declaration of any type generated with `ring_declare`.
+ * Example: `ring_init(myRing, ring32, uint32_t, 16);`
+ * Declares: `uint32_t myRing_storage[16]; ring32_t myRing = { myRing_storage, 16, 0, 0, 0 };`
+ * @param Name Name of the ring variable.
+ * @param Prefix Ring type prefix passed to `ring_declare`.
+ * @param Type Element type.
  * @param Limit Capacity of the ring buffer (number of elements).
  */
-#define ring16_init(Name, Limit) \
-  uint16_t Name##_storage[Limit]; \
-  ring16_t Name = { \
+#define ring_init(Name, Prefix, Type, Limit) \
+  Type Name##_storage[Limit]; \
+  Prefix##_t Name = { \
     .memory = Name##_storage, \
     .limit  = (Limit), \
     .head   = 0, \
@@ -20,19 +37,125 @@
     .count  = 0 \
   }
 
-typedef struct {
-  uint16_t *memory;
-  uint16_t limit;
-  uint16_t head;
-  uint16_t tail;
-  uint16_t count;
-} ring16_t;
-
-void ring16_push(ring16_t *ring, uint16_t value);
-uint8_t ring16_pop(ring16_t *ring, uint16_t *out_value);
-uint8_t ring16_peek(const ring16_t *ring, uint16_t *out_value);
-uint8_t ring16_peek_last(const ring16_t *ring, uint16_t *out_value);
-uint16_t ring16_copy_last(ring16_t *ring, uint16_t n, uint16_t *out_array);
-void ring16_clear(ring16_t *ring);
+/**
+ * @brief Declares ring type `Prefix##_t` of `Type` elements and its functions (use in header).
+ *   `push` writes at `head` and overwrites the oldest element when full, `pop` reads from `tail`.
+ *   Index arithmetic uses `ring_wrap`, so there is no division for any capacity
+ *   (except one modulo when `push_n` gets more values than the ring holds).
+ * @param Prefix Name prefix of type and functions (e.g. `ring16` gives `ring16_t`, `ring16_push`...).
+ * @param Type Element type.
+ */
+#define ring_declare(Prefix, Type) \
+  typedef struct { \
+    Type *memory; \
+    uint16_t limit; \
+    uint16_t head; \
+    uint16_t tail; \
+    uint16_t count; \
+  } Prefix##_t; \
+  void Prefix##_push(Prefix##_t *ring, Type value); \
+  uint8_t Prefix##_pop(Prefix##_t *ring, Type *out_value); \
+  uint8_t Prefix##_peek(const Prefix##_t *ring, Type *out_value); \
+  uint8_t Prefix##_peek_last(const Prefix##_t *ring, Type *out_value); \
+  uint16_t Prefix##_copy_last(Prefix##_t *ring, uint16_t n, Type *out_array); \
+  void Prefix##_push_n(Prefix##_t *ring, const Type *values, uint16_t n); \
+  uint16_t Prefix##_pop_n(Prefix##_t *ring, Type *out_array, uint16_t n); \
+  void Prefix##_clear(Prefix##_t *ring)
+
+/**
+ * @brief Defines functions of ring type declared with `ring_declare` (use in one source file).
+ *   Bulk `push_n`, `pop_n` and `copy_last` move data with at most two `memcpy` calls.
+ * @param Prefix Name prefix of type and functions.
+ * @param Type Element type.
+ */
+#define ring_define(Prefix, Type) \
+  void Prefix##_push(Prefix##_t *ring, Type value) \
+  { \
+    ring->memory[ring->head] = value; \
+    if(ring->count == ring->limit) ring->tail = ring_wrap(ring->tail, 1, ring->limit); \
+    else ring->count++; \
+    ring->head = ring_wrap(ring->head, 1, ring->limit); \
+  } \
+  uint8_t Prefix##_pop(Prefix##_t *ring, Type *out_value) \
+  { \
+    if(ring->count == 0) return 0; \
+    if(out_value) *out_value = ring->memory[ring->tail]; \
+    ring->tail = ring_wrap(ring->tail, 1, ring->limit); \
+    ring->count--; \
+    return 1; \
+  } \
+  uint8_t Prefix##_peek(const Prefix##_t *ring, Type *out_value) \
+  { \
+    if(ring->count == 0) return 0; \
+    if(out_value) *out_value = ring->memory[ring->tail]; \
+    return 1; \
+  } \
+  uint8_t Prefix##_peek_last(const Prefix##_t *ring, Type *out_value) \
+  { \
+    if(ring->count == 0) return 0; \
+    uint16_t idx = (ring->head == 0 ? ring->limit - 1 : ring->head - 1); \
+    if(out_value) *out_value = ring->memory[idx]; \
+    return 1; \
+  } \
+  static void Prefix##_read(const Prefix##_t *ring, uint16_t start, uint16_t n, Type *out_array) \
+  { \
+    uint16_t first = (uint16_t)(ring->limit - start); \
+    if(first > n) first = n; \
+    memcpy(out_array, &ring->memory[start], first * sizeof(Type)); \
+    memcpy(&out_array[first], ring->memory, (n - first) * sizeof(Type)); \
+  } \
+  uint16_t Prefix##_copy_last(Prefix##_t *ring, uint16_t n, Type *out_array) \
+  { \
+    if(ring->count == 0) return 0; \
+    if(n > ring->count) n = ring->count; \
+    Prefix##_read(ring, ring_wrap(ring->tail, ring->count - n, ring->limit), n, out_array); \
+    return n; \
+  } \
+  void Prefix##_push_n(Prefix##_t *ring, const Type *values, uint16_t n) \
+  { \
+    uint32_t count = (uint32_t)ring->count + n; \
+    if(n > ring->limit) { \
+      /* Only last `limit` values stay, head moves as if all were pushed one by one */ \
+      uint16_t skip = n - ring->limit; \
+      values += skip; \
+      n = ring->limit; \
+      ring->head = (uint16_t)((ring->head + skip) % ring->limit); /* Rare overflow path */ \
+    } \
+    uint16_t first = (uint16_t)(ring->limit - ring->head); \
+    if(first > n) first = n; \
+    memcpy(&ring->memory[ring->head], values, first * sizeof(Type)); \
+    memcpy(ring->memory, &values[first], (n - first) * sizeof(Type)); \
+    ring->head = ring_wrap(ring->head, n, ring->limit); \
+    if(count > ring->limit) { \
+      ring->count = ring->limit; \
+      ring->tail = ring->head; \
+    } \
+    else ring->count = (uint16_t)count; \
+  } \
+  uint16_t Prefix##_pop_n(Prefix##_t *ring, Type *out_array, uint16_t n) \
+  { \
+    if(n > ring->count) n = ring->count; \
+    if(out_array) Prefix##_read(ring, ring->tail, n, out_array); \
+    ring->tail = ring_wrap(ring->tail, n, ring->limit); \
+    ring->count -= n; \
+    return n; \
+  } \
+  void Prefix##_clear(Prefix##_t *ring) \
+  { \
+    ring->head = 0; \
+    ring->tail = 0; \
+    ring->count = 0; \
+  }
+
+ring_declare(ring16, uint16_t);
+
+/**
+ * @brief Helper macro for static ring16_t declaration.
+ * Example: `ring16_init(myRing, 16);`
+ * Declares: `uint16_t myRing_storage[16]; ring16_t myRing = { myRing_storage, 16, 0, 0, 0 };`
+ * @param Name Name of the ring16_t variable.
+ * @param Limit Capacity of the ring buffer (number of elements).
+ */
+#define ring16_init(Name, Limit) ring_init(Name, ring16, uint16_t, Limit)
 
 #endif
\ No newline at end of file
@@ -73,10 +73,11 @@ uint8_t ADC_Record(ADC_t *adc)
   }
   if(adc->record.continuous_mode) {
     adc->record.dma.cha->CCR |= DMA_CCR_CIRC;
-    adc->record.dma.cha->CCR &= ~DMA_CCR_TCIE;
+    if(adc->record.ChunkHandler) adc->record.dma.cha->CCR |= DMA_CCR_HTIE | DMA_CCR_TCIE;
+    else adc->record.dma.cha->CCR &= ~(DMA_CCR_HTIE | DMA_CCR_TCIE);
   }
   else {
-    adc->record.dma.cha->CCR &= ~DMA_CCR_CIRC;
+    adc->record.dma.cha->CCR &= ~(DMA_CCR_CIRC | DMA_CCR_HTIE);
     adc->record.dma.cha->CCR |= DMA_CCR_TCIE;
   }
   adc->record.dma.cha->CCR |= DMA_CCR_EN;
@@ -215,9 +216,17 @@ static void ADC_InterruptEV(ADC_t *adc)
 #if(ADC_RECORD)
 static void ADC_InterruptDMA(ADC_t *adc)
 {
+  uint16_t half = adc->record.buff_len / 2;
+  if(adc->record.dma.reg->ISR & DMA_ISR_HTIF(adc->record.dma.pos)) {
+    adc->record.dma.reg->IFCR |= DMA_ISR_HTIF(adc->record.dma.pos);
+    if(adc->record.ChunkHandler) adc->record.ChunkHandler(adc->record.buff, half, adc->record.chunk_arg);
+  }
   if(adc->record.dma.reg->ISR & DMA_ISR_TCIF(adc->record.dma.pos)) {
     adc->record.dma.reg->IFCR |= DMA_ISR_TCIF(adc->record.dma.pos);
-    ADC_Stop(adc);
+    if(!adc->record.continuous_mode) ADC_Stop(adc);
+    else if(adc->record.ChunkHandler) {
+      adc->record.ChunkHandler(&adc->record.buff[half], adc->record.buff_len - half, adc->record.chunk_arg);
+    }
   }
 }
 #endif
@@ -123,6 +123,10 @@ typedef struct {
   uint16_t buff_len;
   TIM_t *tim;
   DMA_t dma;
+  // In `continuous_mode`: called from DMA interrupt with each filled half of `buff`
+  // (`buff_len / 2` interleaved samples, keep it a multiple of `chan_count`), e.g. to feed `MEDIAN_PushChunk`
+  void (*ChunkHandler)(uint16_t *samples, uint16_t count, void *arg);
+  void *chunk_arg;
 } ADC_Record_t;
 #endif
 
@@ -254,14 +254,31 @@ void RTC_Reset(void)
 
 //------------------------------------------------------------------------------------------------- GET
 
-RTC_Datetime_t RTC_Datetime(void)
+/**
+ * @brief Read raw calendar registers without waiting for shadow resynchronization.
+ *   Reading `SSR` locks `TR` and `DR` shadows until `DR` is read, so the values are coherent.
+ *   Cheap check whether second has changed, e.g. for cached log timestamp.
+ * @param[out] time Raw BCD value of `RTC->TR`.
+ * @param[out] date Raw BCD value of `RTC->DR`.
+ * @return Milliseconds of current second (from `RTC->SSR`).
+ */
+uint16_t RTC_Raw(uint32_t *time, uint32_t *date)
 {
-  RTC_Datetime_t datetime;
-  RTC->ICSR &= ~RTC_ICSR_RSF;
-  while(!(RTC->ICSR & RTC_ICSR_RSF)) __DSB();
   uint32_t subsecund = RTC->SSR;
-  uint32_t time = RTC->TR;
-  uint32_t date = RTC->DR;
+  *time = RTC->TR;
+  *date = RTC->DR;
+  return ((PREDIV_S - subsecund) * ((PREDIV_A + 1) * 10000) / (RTC_LSE_FREQUENCY)) / 10;
+}
+
+/**
+ * @brief Decode raw BCD calendar registers (see `RTC_Raw`) to datetime, `ms` is left `0`.
+ * @param[in] time Raw value of `RTC->TR`.
+ * @param[in] date Raw value of `RTC->DR`.
+ * @return Decoded datetime.
+ */
+RTC_Datetime_t RTC_RawToDatetime(uint32_t time, uint32_t date)
+{
+  RTC_Datetime_t datetime;
   datetime.year = ((date & RTC_DR_YT) >> RTC_DR_YT_Pos) * 10;
   datetime.year += ((date & RTC_DR_YU) >> RTC_DR_YU_Pos);
   if(datetime.year >= 22) rtc_ready = true;
@@ -276,7 +293,18 @@ RTC_Datetime_t RTC_Datetime(void)
   datetime.minute += ((time & RTC_TR_MNU) >> RTC_TR_MNU_Pos);
   datetime.second = ((time & RTC_TR_ST) >> RTC_TR_ST_Pos) * 10;
   datetime.second += ((time & RTC_TR_SU) >> RTC_TR_SU_Pos);
-  datetime.ms = ((PREDIV_S - subsecund) * ((PREDIV_A + 1) * 10000) / (RTC_LSE_FREQUENCY)) / 10;
+  datetime.ms = 0;
+  return datetime;
+}
+
+RTC_Datetime_t RTC_Datetime(void)
+{
+  RTC->ICSR &= ~RTC_ICSR_RSF;
+  while(!(RTC->ICSR & RTC_ICSR_RSF)) __DSB();
+  uint32_t time, date;
+  uint16_t ms = RTC_Raw(&time, &date);
+  RTC_Datetime_t datetime = RTC_RawToDatetime(time, date);
+  datetime.ms = ms;
   return datetime;
 }
 
@@ -78,6 +78,8 @@ void RTC_SetDatetime(RTC_Datetime_t *datetime);
 void RTC_SetTimestamp(uint64_t timestamp);
 void RTC_Reset(void);
 
+uint16_t RTC_Raw(uint32_t *time, uint32_t *date);
+RTC_Datetime_t RTC_RawToDatetime(uint32_t time, uint32_t date);
 RTC_Datetime_t RTC_Datetime(void);
 uint32_t RTC_Timestamp(void);
 uint64_t RTC_TimestampMs(void);
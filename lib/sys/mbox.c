@@ -0,0 +1,188 @@
+#include "mbox.h"
+
+//------------------------------------------------------------------------------------------------- critical
+
+static inline uint32_t MBOX_Lock(void)
+{
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  return primask;
+}
+
+static inline void MBOX_Unlock(uint32_t primask)
+{
+  __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Number of messages the receiver may take (those before an open reservation).
+ */
+static inline uint16_t MBOX_Ready(MBOX_t *mbox)
+{
+  return mbox->reserved ? mbox->ahead : mbox->queue.count;
+}
+
+/**
+ * @brief Block calling thread until mailbox is notified or tick `end` passes.
+ *   Emptiness is checked with interrupts disabled, so a send cannot be missed.
+ * @param[in] mbox Pointer to `MBOX_t` mailbox.
+ * @param[in] end Timeout tick, `0` for none.
+ */
+static void MBOX_Block(MBOX_t *mbox, uint64_t end)
+{
+  uint32_t primask = MBOX_Lock();
+  bool empty = !MBOX_Ready(mbox);
+  if(empty) vrts_block(mbox, end);
+  MBOX_Unlock(primask);
+  if(empty) {
+    let();
+    vrts_block(NULL, 0);
+  }
+}
+
+//------------------------------------------------------------------------------------------------- producer
+
+/**
+ * @brief Send message by copy. Non-blocking, safe to call from interrupts.
+ *   While a reservation is open, message waits behind the reserved slot.
+ * @param[in,out] mbox Pointer to `MBOX_t` mailbox.
+ * @param[in] msg Pointer to message (`struct_size` bytes).
+ * @return `true` if queued, `false` if mailbox is full.
+ */
+bool MBOX_Send(MBOX_t *mbox, const void *msg)
+{
+  uint32_t primask = MBOX_Lock();
+  bool ok = QUEUE_Push(&mbox->queue, msg);
+  MBOX_Unlock(primask);
+  if(ok) vrts_notify(mbox);
+  return ok;
+}
+
+/**
+ * @brief Reserve the next free slot and fill it in place (copy-free send).
+ *   Only one reservation may be open at a time. Slot is taken from the queue right away,
+ *   so `MBOX_Send` keeps working until it is committed.
+ * @param[in,out] mbox Pointer to `MBOX_t` mailbox.
+ * @return Pointer to slot memory, `NULL` if mailbox is full or already reserved.
+ */
+void *MBOX_Reserve(MBOX_t *mbox)
+{
+  uint32_t primask = MBOX_Lock();
+  void *slot = mbox->reserved ? NULL : QUEUE_Reserve(&mbox->queue);
+  if(slot) {
+    mbox->ahead = mbox->queue.count;
+    QUEUE_Commit(&mbox->queue);
+    mbox->reserved = true;
+  }
+  MBOX_Unlock(primask);
+  return slot;
+}
+
+/**
+ * @brief Publish slot obtained from `MBOX_Reserve` (and messages sent after it) to the receiver.
+ * @param[in,out] mbox Pointer to `MBOX_t` mailbox.
+ * @return `true` if committed, `false` if there was no open reservation.
+ */
+bool MBOX_Commit(MBOX_t *mbox)
+{
+  uint32_t primask = MBOX_Lock();
+  bool ok = mbox->reserved;
+  mbox->reserved = false;
+  MBOX_Unlock(primask);
+  if(ok) vrts_notify(mbox);
+  return ok;
+}
+
+//------------------------------------------------------------------------------------------------- consumer
+
+/**
+ * @brief Receive message by copy if one is available.
+ * @param[in,out] mbox Pointer to `MBOX_t` mailbox.
+ * @param[out] msg Pointer to memory where message will be copied.
+ * @return `true` if message received, `false` if mailbox is empty.
+ */
+bool MBOX_TryRecv(MBOX_t *mbox, void *msg)
+{
+  if(!MBOX_Ready(mbox)) return false;
+  uint32_t primask = MBOX_Lock();
+  bool ok = QUEUE_Pop(&mbox->queue, msg);
+  if(ok && mbox->reserved) mbox->ahead--;
+  MBOX_Unlock(primask);
+  return ok;
+}
+
+/**
+ * @brief Receive message by copy, blocking the thread until one arrives.
+ * @param[in,out] mbox Pointer to `MBOX_t` mailbox.
+ * @param[out] msg Pointer to memory where message will be copied.
+ */
+void MBOX_Recv(MBOX_t *mbox, void *msg)
+{
+  while(!MBOX_TryRecv(mbox, msg)) MBOX_Block(mbox, 0);
+}
+
+/**
+ * @brief Receive message by copy, blocking the thread until one arrives or time runs out.
+ * @param[in,out] mbox Pointer to `MBOX_t` mailbox.
+ * @param[out] msg Pointer to memory where message will be copied.
+ * @param[in] ms Timeout in milliseconds.
+ * @return `true` if message received, `false` on timeout.
+ */
+bool MBOX_RecvTimeout(MBOX_t *mbox, void *msg, uint32_t ms)
+{
+  uint64_t end = tick_keep(ms);
+  while(!MBOX_TryRecv(mbox, msg)) {
+    if(end <= tick_read()) return false;
+    MBOX_Block(mbox, end);
+  }
+  return true;
+}
+
+/**
+ * @brief Wait for the oldest message and access it in place (copy-free receive).
+ *   Message stays in the mailbox until `MBOX_Release` is called.
+ * @param[in] mbox Pointer to `MBOX_t` mailbox.
+ * @return Pointer to message memory.
+ */
+void *MBOX_Wait(MBOX_t *mbox)
+{
+  while(!MBOX_Ready(mbox)) MBOX_Block(mbox, 0);
+  return QUEUE_Front(&mbox->queue);
+}
+
+/**
+ * @brief Free the slot of message returned by `MBOX_Wait`.
+ * @param[in,out] mbox Pointer to `MBOX_t` mailbox.
+ */
+void MBOX_Release(MBOX_t *mbox)
+{
+  uint32_t primask = MBOX_Lock();
+  if(QUEUE_Drop(&mbox->queue) && mbox->reserved) mbox->ahead--;
+  MBOX_Unlock(primask);
+}
+
+//------------------------------------------------------------------------------------------------- state
+
+/**
+ * @brief Get number of messages waiting in mailbox (not counting those behind a reservation).
+ * @param[in] mbox Pointer to `MBOX_t` mailbox.
+ * @return Current number of messages.
+ */
+uint16_t MBOX_Count(MBOX_t *mbox)
+{
+  return MBOX_Ready(mbox);
+}
+
+/**
+ * @brief Discard all pending messages and any open reservation.
+ * @param[in,out] mbox Pointer to `MBOX_t` mailbox.
+ */
+void MBOX_Clear(MBOX_t *mbox)
+{
+  uint32_t primask = MBOX_Lock();
+  QUEUE_Clear(&mbox->queue);
+  mbox->reserved = false;
+  MBOX_Unlock(primask);
+}
+
+//-------------------------------------------------------------------------------------------------
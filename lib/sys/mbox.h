@@ -0,0 +1,56 @@
+#ifndef MBOX_H_
+#define MBOX_H_
+
+#include "queue.h"
+#include "vrts.h"
+
+//-------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Inter-thread mailbox: fixed-size FIFO of typed messages built on `QUEUE_t` storage.
+ *   `Send`/`Reserve`/`Commit` are non-blocking and may be called from interrupts.
+ *   `Recv`/`Wait` block the calling thread in VRTS (`vrts_block`) until a message arrives;
+ *   a blocked receiver is skipped by the scheduler and uses no CPU while waiting.
+ *   Messages sent while a reservation is open are queued behind the reserved slot
+ *   and become visible together with it on `MBOX_Commit`.
+ * @param queue Ring storage (FIFO only, no `unique`, `invert` or `Compare`).
+ * @param reserved `true` while a producer holds a slot from `MBOX_Reserve`. [internal]
+ * @param ahead Messages queued before the reserved slot (visible to receiver). [internal]
+ */
+typedef struct {
+  QUEUE_t queue;
+  volatile bool reserved;
+  volatile uint16_t ahead;
+} MBOX_t;
+
+/**
+ * @brief Helper macro for static mailbox declaration.
+ * Example: `mbox_new(adc_box, ADC_Chunk_t, 4);`
+ * Declares: `ADC_Chunk_t adc_box_storage[4]; MBOX_t adc_box = { ... };`
+ * @param Name Name of the `MBOX_t` variable.
+ * @param Type Message type.
+ * @param Limit Mailbox capacity (number of messages).
+ */
+#define mbox_new(Name, Type, Limit) \
+  Type Name##_storage[Limit]; \
+  MBOX_t Name = { \
+    .queue = { \
+      .buffer = Name##_storage, \
+      .struct_size = sizeof(Type), \
+      .capacity = (Limit) \
+    } \
+  }
+
+bool MBOX_Send(MBOX_t *mbox, const void *msg);
+void *MBOX_Reserve(MBOX_t *mbox);
+bool MBOX_Commit(MBOX_t *mbox);
+bool MBOX_TryRecv(MBOX_t *mbox, void *msg);
+void MBOX_Recv(MBOX_t *mbox, void *msg);
+bool MBOX_RecvTimeout(MBOX_t *mbox, void *msg, uint32_t ms);
+void *MBOX_Wait(MBOX_t *mbox);
+void MBOX_Release(MBOX_t *mbox);
+uint16_t MBOX_Count(MBOX_t *mbox);
+void MBOX_Clear(MBOX_t *mbox);
+
+//-------------------------------------------------------------------------------------------------
+#endif
@@ -1,56 +1,268 @@
 #include "task.h"
-#include "log.h"
+#ifdef OpenCPLC
+  #include "log.h"
+#endif
 
-static bool TASK_Equal(const void *a, const void *b)
+#define TASK_NIL 0xFFFF // No task (end of list)
+#define TASK_SLOT_READY 0xFFFE // Task is due and waits in ready list
+#define TASK_SLOT_NONE 0xFFFF // Task pool entry is free
+#define TASK_WHEEL_BITS 6
+#define TASK_WHEEL_SIZE (1 << TASK_WHEEL_BITS)
+#define TASK_WHEEL_MASK (TASK_WHEEL_SIZE - 1)
+#define TASK_WHEEL_HORIZON (1ull << (TASK_WHEEL_BITS * TASK_WHEEL_LEVELS))
+
+static TASK_t task_pool[TASK_LIMIT];
+
+/**
+ * @brief Hierarchical timer wheel state.
+ * Level `n` slot covers `64^n` ticks. Each slot is a doubly linked list of pool indexes,
+ * so insert, cancel and expiry are O(1); lists of higher levels are cascaded down
+ * when the level below wraps.
+ */
+static struct {
+  uint16_t slot[TASK_WHEEL_LEVELS * TASK_WHEEL_SIZE]; // List heads
+  uint64_t occupied[TASK_WHEEL_LEVELS]; // Non-empty slot bitmap per level
+  uint16_t ready_head;
+  uint16_t ready_tail;
+  uint16_t free; // Free pool list head
+  uint16_t count; // Pending tasks
+  uint64_t now; // Last processed tick
+  bool init;
+} task_wheel;
+
+//------------------------------------------------------------------------------------------------- lists
+
+static void TASK_Init(void)
+{
+  if(task_wheel.init) return;
+  for(uint16_t i = 0; i < TASK_WHEEL_LEVELS * TASK_WHEEL_SIZE; i++) task_wheel.slot[i] = TASK_NIL;
+  for(uint16_t i = 0; i < TASK_LIMIT; i++) {
+    task_pool[i].next = (i + 1 < TASK_LIMIT) ? i + 1 : TASK_NIL;
+    task_pool[i].slot = TASK_SLOT_NONE;
+  }
+  task_wheel.free = 0;
+  task_wheel.ready_head = TASK_NIL;
+  task_wheel.ready_tail = TASK_NIL;
+  task_wheel.now = tick_read();
+  task_wheel.init = true;
+}
+
+static void TASK_Link(uint16_t idx, uint16_t slot)
+{
+  TASK_t *task = &task_pool[idx];
+  task->slot = slot;
+  if(slot == TASK_SLOT_READY) { // FIFO: append at tail
+    task->next = TASK_NIL;
+    task->prev = task_wheel.ready_tail;
+    if(task_wheel.ready_tail != TASK_NIL) task_pool[task_wheel.ready_tail].next = idx;
+    else task_wheel.ready_head = idx;
+    task_wheel.ready_tail = idx;
+    return;
+  }
+  task->prev = TASK_NIL;
+  task->next = task_wheel.slot[slot];
+  if(task->next != TASK_NIL) task_pool[task->next].prev = idx;
+  task_wheel.slot[slot] = idx;
+  task_wheel.occupied[slot >> TASK_WHEEL_BITS] |= 1ull << (slot & TASK_WHEEL_MASK);
+}
+
+static void TASK_Unlink(uint16_t idx)
+{
+  TASK_t *task = &task_pool[idx];
+  if(task->prev != TASK_NIL) task_pool[task->prev].next = task->next;
+  else if(task->slot == TASK_SLOT_READY) task_wheel.ready_head = task->next;
+  else {
+    task_wheel.slot[task->slot] = task->next;
+    if(task->next == TASK_NIL) task_wheel.occupied[task->slot >> TASK_WHEEL_BITS] &= ~(1ull << (task->slot & TASK_WHEEL_MASK));
+  }
+  if(task->next != TASK_NIL) task_pool[task->next].prev = task->prev;
+  else if(task->slot == TASK_SLOT_READY) task_wheel.ready_tail = task->prev;
+}
+
+/**
+ * @brief Put task into the wheel slot matching its `tick` (or ready list if already due).
+ * @param[in] idx Pool index of task.
+ */
+static void TASK_Place(uint16_t idx)
+{
+  TASK_t *task = &task_pool[idx];
+  if(task->tick <= task_wheel.now) {
+    TASK_Link(idx, TASK_SLOT_READY);
+    return;
+  }
+  uint64_t delta = task->tick - task_wheel.now;
+  uint64_t tick = task->tick;
+  if(delta >= TASK_WHEEL_HORIZON) tick = task_wheel.now + TASK_WHEEL_HORIZON - 1; // Re-placed on cascade
+  uint8_t level = 0;
+  while(level < TASK_WHEEL_LEVELS - 1 && delta >= (1ull << (TASK_WHEEL_BITS * (level + 1)))) level++;
+  uint16_t pos = (uint16_t)((tick >> (TASK_WHEEL_BITS * level)) & TASK_WHEEL_MASK);
+  TASK_Link(idx, level * TASK_WHEEL_SIZE + pos);
+}
+
+static uint16_t TASK_Alloc(void)
+{
+  uint16_t idx = task_wheel.free;
+  if(idx == TASK_NIL) return TASK_NIL;
+  task_wheel.free = task_pool[idx].next;
+  task_wheel.count++;
+  return idx;
+}
+
+static void TASK_Free(uint16_t idx)
+{
+  TASK_t *task = &task_pool[idx];
+  task->slot = TASK_SLOT_NONE;
+  task->gen++; // Invalidate handles
+  task->next = task_wheel.free;
+  task_wheel.free = idx;
+  task_wheel.count--;
+}
+
+static inline TASK_Handle_t TASK_Handle(uint16_t idx)
+{
+  return ((uint32_t)task_pool[idx].gen << 16) | (idx + 1);
+}
+
+/**
+ * @brief Resolve handle to pool index.
+ * @param[in] handle Task handle.
+ * @return Pool index, `TASK_NIL` if task already ran, was cancelled or handle is invalid.
+ */
+static uint16_t TASK_Find(TASK_Handle_t handle)
+{
+  uint32_t idx = (handle & 0xFFFF) - 1;
+  if(!task_wheel.init || idx >= TASK_LIMIT) return TASK_NIL;
+  TASK_t *task = &task_pool[idx];
+  if(task->slot == TASK_SLOT_NONE || task->gen != (uint16_t)(handle >> 16)) return TASK_NIL;
+  return (uint16_t)idx;
+}
+
+//------------------------------------------------------------------------------------------------- wheel
+
+static void TASK_Cascade(uint8_t level, uint16_t pos)
+{
+  uint16_t slot = level * TASK_WHEEL_SIZE + pos;
+  uint16_t idx = task_wheel.slot[slot];
+  task_wheel.slot[slot] = TASK_NIL;
+  task_wheel.occupied[level] &= ~(1ull << pos);
+  while(idx != TASK_NIL) {
+    uint16_t next = task_pool[idx].next;
+    TASK_Place(idx);
+    idx = next;
+  }
+}
+
+static void TASK_Expire(uint16_t pos)
+{
+  uint16_t idx = task_wheel.slot[pos];
+  if(idx == TASK_NIL) return;
+  task_wheel.slot[pos] = TASK_NIL;
+  task_wheel.occupied[0] &= ~(1ull << pos);
+  while(task_pool[idx].next != TASK_NIL) idx = task_pool[idx].next;
+  while(idx != TASK_NIL) { // Oldest first
+    uint16_t prev = task_pool[idx].prev;
+    TASK_Link(idx, TASK_SLOT_READY);
+    idx = prev;
+  }
+}
+
+/**
+ * @brief Advance wheel up to `now`, moving due tasks to ready list.
+ *   Empty stretches are skipped with the level-0 bitmap, cost is O(due slots + elapsed / 64).
+ * @param[in] now Current tick.
+ */
+static void TASK_Advance(uint64_t now)
 {
-  const TASK_t *task_a = a, *task_b = b;
-  return task_a->unique_key && task_b->unique_key && (task_a->unique_key == task_b->unique_key);
+  while(task_wheel.now < now) {
+    uint32_t pos = (uint32_t)(task_wheel.now & TASK_WHEEL_MASK);
+    uint32_t step = TASK_WHEEL_SIZE - pos; // To next level-1 boundary
+    if(pos < TASK_WHEEL_MASK) {
+      uint64_t ahead = task_wheel.occupied[0] >> (pos + 1);
+      if(ahead) step = __builtin_ctzll(ahead) + 1;
+    }
+    if(task_wheel.now + step > now) {
+      task_wheel.now = now;
+      break;
+    }
+    task_wheel.now += step;
+    uint64_t tick = task_wheel.now;
+    if(!(tick & TASK_WHEEL_MASK)) {
+      uint8_t top = 1;
+      while(top < TASK_WHEEL_LEVELS - 1 && !((tick >> (TASK_WHEEL_BITS * top)) & TASK_WHEEL_MASK)) top++;
+      for(uint8_t level = top; level >= 1; level--) { // Higher levels first, they refill lower ones
+        TASK_Cascade(level, (uint16_t)((tick >> (TASK_WHEEL_BITS * level)) & TASK_WHEEL_MASK));
+      }
+    }
+    TASK_Expire((uint16_t)(tick & TASK_WHEEL_MASK));
+  }
 }
 
-static int32_t TASK_Compare(const void *a, const void *b)
+/**
+ * @brief Tick of the next wheel event: earliest level-0 expiry or cascade of an occupied slot.
+ *   Lower levels are searched first, their events always come before those of higher levels.
+ *   Slots behind the current position belong to the next rotation of their level,
+ *   which starts with a cascade of the level above.
+ * @return Tick at which `TASK_Main` has work to do, `UINT64_MAX` if no task is pending.
+ */
+static uint64_t TASK_NextEvent(void)
 {
-  const TASK_t *task_a = a, *task_b = b;
-  if(task_a->tick < task_b->tick) return -1;
-  if(task_a->tick > task_b->tick) return 1;
-  return 0;
+  if(task_wheel.ready_head != TASK_NIL) return task_wheel.now;
+  for(uint8_t level = 0; level < TASK_WHEEL_LEVELS; level++) {
+    uint8_t shift = TASK_WHEEL_BITS * level;
+    uint32_t pos = (uint32_t)((task_wheel.now >> shift) & TASK_WHEEL_MASK);
+    uint64_t base = task_wheel.now & ~((1ull << (shift + TASK_WHEEL_BITS)) - 1); // Start of rotation
+    uint64_t occupied = task_wheel.occupied[level];
+    if(pos < TASK_WHEEL_MASK) {
+      uint64_t ahead = occupied >> (pos + 1);
+      if(ahead) return base + ((uint64_t)(pos + 1 + __builtin_ctzll(ahead)) << shift);
+    }
+    if(occupied) return base + (1ull << (shift + TASK_WHEEL_BITS));
+  }
+  return UINT64_MAX;
 }
 
-static TASK_t task_buffer[TASK_LIMIT];
-static QUEUE_t task_queue = {
-  .buffer = (void *)task_buffer,
-  .struct_size = sizeof(TASK_t),
-  .capacity = TASK_LIMIT,
-  .unique = true,
-  .invert = true,
-  .Equal = TASK_Equal,
-  .Compare = TASK_Compare
-};
+//------------------------------------------------------------------------------------------------- api
 
 static inline void TASK_FullError(void)
 {
-  LOG_Error("Task not added: the queue is full" LOG_LIB("TASK"));
+  #ifdef OpenCPLC
+    LOG_Error("Task not added: the queue is full" LOG_LIB("TASK"));
+  #endif
+}
+
+static TASK_Handle_t TASK_Schedule(void (*Handler)(void *), void *arg, uint64_t tick, uint32_t period, int32_t unique_key)
+{
+  uint16_t idx = TASK_Alloc();
+  if(idx == TASK_NIL) {
+    TASK_FullError();
+    return 0;
+  }
+  TASK_t *task = &task_pool[idx];
+  task->Handler = Handler;
+  task->arg = arg;
+  task->tick = tick;
+  task->period = period;
+  task->unique_key = unique_key;
+  TASK_Place(idx);
+  vrts_notify(&task_wheel);
+  return TASK_Handle(idx);
 }
 
 /**
  * @brief Schedule a task after a delay.
  * @param[in] Handler Function to run with delay.
  * @param[in] arg User data passed to Handler.
- * @param[in] delay_ms Delay in milliseconds.
+ * @param[in] delay_ms Delay in milliseconds. If `0`, Handler is called immediately.
+ * @return Task handle, `0` if run immediately or not added.
  */
-void TASK_Add(void (*Handler)(void *), void *arg, uint32_t delay_ms)
+TASK_Handle_t TASK_Add(void (*Handler)(void *), void *arg, uint32_t delay_ms)
 {
   if(!delay_ms) {
     Handler(arg);
-    return;
+    return 0;
   }
-  TASK_t task = {
-    .Handler = Handler,
-    .arg = arg,
-    .tick = tick_keep(delay_ms),
-    .unique_key = 0
-  };
-  bool ok = QUEUE_Push(&task_queue, &task);
-  if(!ok) TASK_FullError();
+  TASK_Init();
+  return TASK_Schedule(Handler, arg, tick_keep(delay_ms), 0, 0);
 }
 
 /**
@@ -59,33 +271,120 @@ void TASK_Add(void (*Handler)(void *), void *arg, uint32_t delay_ms)
  * @param[in] arg User data passed to Handler.
  * @param[in] delay_ms Delay in milliseconds.
  * @param[in] unique_key Application-defined key for de-duplication. Unused if `0`.
+ * @return Task handle, `0` if a pending task has the same key or queue is full.
+ */
+TASK_Handle_t TASK_AddUnique(void (*Handler)(void *), void *arg, uint32_t delay_ms, int32_t unique_key)
+{
+  TASK_Init();
+  if(unique_key) {
+    for(uint16_t i = 0; i < TASK_LIMIT; i++) {
+      if(task_pool[i].slot != TASK_SLOT_NONE && task_pool[i].unique_key == unique_key) return 0;
+    }
+  }
+  return TASK_Schedule(Handler, arg, tick_keep(delay_ms), 0, unique_key);
+}
+
+/**
+ * @brief Schedule a task that runs every `period_ms`, first run after one period.
+ *   Releases are anchored to the first one (no drift), missed periods are skipped.
+ * @param[in] Handler Function to run periodically.
+ * @param[in] arg User data passed to Handler.
+ * @param[in] period_ms Period in milliseconds (at least one tick).
+ * @return Task handle for `TASK_Cancel`/`TASK_Reschedule`, `0` if not added.
+ */
+TASK_Handle_t TASK_AddPeriodic(void (*Handler)(void *), void *arg, uint32_t period_ms)
+{
+  TASK_Init();
+  uint32_t period = tick_span(period_ms);
+  if(!period) period = 1;
+  return TASK_Schedule(Handler, arg, tick_read() + period, period, 0);
+}
+
+/**
+ * @brief Cancel pending task (also stops periodic task, even from its own Handler).
+ * @param[in] handle Task handle.
+ * @return `true` if cancelled, `false` if task is no longer pending.
+ */
+bool TASK_Cancel(TASK_Handle_t handle)
+{
+  uint16_t idx = TASK_Find(handle);
+  if(idx == TASK_NIL) return false;
+  TASK_Unlink(idx);
+  TASK_Free(idx);
+  vrts_notify(&task_wheel);
+  return true;
+}
+
+/**
+ * @brief Move pending task to run `delay_ms` from now. Periodic task is re-anchored.
+ * @param[in] handle Task handle.
+ * @param[in] delay_ms New delay in milliseconds.
+ * @return `true` if rescheduled, `false` if task is no longer pending.
  */
-void TASK_AddUnique(void (*Handler)(void *), void *arg, uint32_t delay_ms, int32_t unique_key)
+bool TASK_Reschedule(TASK_Handle_t handle, uint32_t delay_ms)
 {
-  TASK_t task = {
-    .Handler = Handler,
-    .arg = arg,
-    .tick = tick_keep(delay_ms),
-    .unique_key = unique_key
-  };
-  bool ok = QUEUE_Push(&task_queue, &task);
-  if(!ok) TASK_FullError();
+  uint16_t idx = TASK_Find(handle);
+  if(idx == TASK_NIL) return false;
+  TASK_Unlink(idx);
+  task_pool[idx].tick = tick_keep(delay_ms);
+  TASK_Place(idx);
+  vrts_notify(&task_wheel);
+  return true;
+}
+
+/**
+ * @brief Check if task is still waiting to run.
+ * @param[in] handle Task handle.
+ * @return `true` if pending.
+ */
+bool TASK_IsPending(TASK_Handle_t handle)
+{
+  return TASK_Find(handle) != TASK_NIL;
+}
+
+/**
+ * @brief Get number of pending tasks.
+ * @return Tasks waiting in the wheel or ready list.
+ */
+uint16_t TASK_Count(void)
+{
+  return task_wheel.count;
 }
 
 /**
  * @brief Task scheduler loop.
  * Runs forever: executes due tasks and never returns.
+ * Between deadlines the thread is blocked in VRTS until the next wheel event
+ * or until a task is added, cancelled or rescheduled (`vrts_notify`).
  */
 void TASK_Main(void)
 {
-  TASK_t task;
+  TASK_Init();
   while(1) {
-    if(QUEUE_Peek(&task_queue, &task)) {
-      if(tick_over(&task.tick)) {
-        task.Handler(task.arg);
-        QUEUE_Pop(&task_queue, &task);
+    TASK_Advance(tick_read());
+    while(task_wheel.ready_head != TASK_NIL) {
+      uint16_t idx = task_wheel.ready_head;
+      TASK_t *task = &task_pool[idx];
+      void (*Handler)(void *) = task->Handler;
+      void *arg = task->arg;
+      TASK_Unlink(idx);
+      if(task->period) { // Re-arm before running, so Handler may cancel itself
+        task->tick += task->period;
+        while(task->tick <= task_wheel.now) task->tick += task->period;
+        TASK_Place(idx);
       }
+      else TASK_Free(idx);
+      Handler(arg);
+    }
+    uint64_t next = TASK_NextEvent();
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    bool wait = next > tick_read();
+    if(wait) vrts_block(&task_wheel, next);
+    __set_PRIMASK(primask);
+    if(wait) {
+      let();
+      vrts_block(NULL, 0);
     }
-    let();
   }
-}
\ No newline at end of file
+}
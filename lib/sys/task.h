@@ -1,14 +1,18 @@
 #ifndef TASK_H_
 #define TASK_H_
 
-#include "queue.h"
 #include "vrts.h"
 
-
 #ifndef TASK_LIMIT
   #define TASK_LIMIT 16
 #endif
 
+// Timer wheel geometry: `TASK_WHEEL_LEVELS` levels of 64 slots, each level 64x coarser.
+// Horizon is `64^TASK_WHEEL_LEVELS` ticks, later deadlines are parked in the top level.
+#ifndef TASK_WHEEL_LEVELS
+  #define TASK_WHEEL_LEVELS 4
+#endif
+
 #define TASK_ (void (*)(void *)) // Type cast for timeout function
 
 /**
@@ -17,16 +21,37 @@
  * @param[in] arg Opaque user pointer passed to `Handler`.
  * @param[in] tick Future-time marker.
  * @param[in] unique_key Optional stable identifier for uniqueness filtering, unused if `0`.
+ * @param period Reload in ticks for periodic task, `0` for one-shot. [internal]
+ * @param next Next task in the same wheel slot or free list. [internal]
+ * @param prev Previous task in the same wheel slot. [internal]
+ * @param slot Wheel slot holding the task, `0xFFFF` when free. [internal]
+ * @param gen Generation counter, invalidates stale handles. [internal]
  */
 typedef struct {
   void (*Handler)(void *);
   void *arg;
   uint64_t tick;
   int32_t unique_key;
+  uint32_t period;
+  uint16_t next;
+  uint16_t prev;
+  uint16_t slot;
+  uint16_t gen;
 } TASK_t;
 
-void TASK_Add(void (*Handler)(void *), void *arg, uint32_t delay_ms);
-void TASK_AddUnique(void (*Handler)(void *), void *arg, uint32_t delay_ms, int32_t unique_key);
+/**
+ * @brief Handle of scheduled task: generation (high half) and pool index + 1 (low half).
+ *   `0` means no task (not scheduled, run immediately or rejected).
+ */
+typedef uint32_t TASK_Handle_t;
+
+TASK_Handle_t TASK_Add(void (*Handler)(void *), void *arg, uint32_t delay_ms);
+TASK_Handle_t TASK_AddUnique(void (*Handler)(void *), void *arg, uint32_t delay_ms, int32_t unique_key);
+TASK_Handle_t TASK_AddPeriodic(void (*Handler)(void *), void *arg, uint32_t period_ms);
+bool TASK_Cancel(TASK_Handle_t handle);
+bool TASK_Reschedule(TASK_Handle_t handle, uint32_t delay_ms);
+bool TASK_IsPending(TASK_Handle_t handle);
+uint16_t TASK_Count(void);
 void TASK_Main(void);
 
 #endif
\ No newline at end of file
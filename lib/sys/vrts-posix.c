@@ -0,0 +1,162 @@
+/**
+ * @file  vrts-posix.c
+ * @brief Host (Linux/POSIX) port of VRTS, enabled with `VRTS_POSIX=1`.
+ *        Replaces `vrts-pendsv.s` and the Cortex-M parts of `vrts.c`: threads run on `ucontext`,
+ *        `let()` is a `swapcontext` and SysTick is simulated. Scheduler and timing code stays
+ *        in `vrts.c`, so `let()`, `delay()` and `timeout()` behave exactly as on the target.
+ *        `VRTS_POSIX_REALTIME=0`: virtual clock, `VrtsTicker` advances every
+ *        `VRTS_POSIX_LETS_PER_TICK` yields and on every idle wait (deterministic runs).
+ *        `VRTS_POSIX_REALTIME=1`: `VrtsTicker` is driven by `setitimer` and `SIGALRM`.
+ *        `vrts_init()` returns once any thread calls `vrts_posix_stop()`.
+ * @date  2026-10-19
+ */
+
+#include "vrts.h"
+
+#if(VRTS_POSIX)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <signal.h>
+#include <ucontext.h>
+#include <sys/time.h>
+
+void SysTick_Handler(void);
+
+static ucontext_t posix_main; // Context of `vrts_init()` caller
+static ucontext_t posix_thread[VRTS_THREAD_LIMIT];
+static void (*posix_handler[VRTS_THREAD_LIMIT])(void);
+static void (*posix_finished)(void);
+static uint8_t posix_stack[VRTS_THREAD_LIMIT][VRTS_POSIX_STACK_SIZE] __attribute__((aligned(16)));
+static volatile uint64_t posix_lets; // Total number of context switches
+
+/**
+ * @brief Thread entry point: runs handler and falls into `finished` when it returns.
+ * @param slot Thread slot index.
+ */
+static void VRTS_PosixEntry(int slot)
+{
+  posix_handler[slot]();
+  posix_finished();
+}
+
+/**
+ * @brief Prepares execution context for thread slot.
+ *   User stack passed to `vrts_thread()` is not used, each slot has its own host stack.
+ * @param slot Thread slot index.
+ * @param handler Thread main function.
+ * @param finished Function called when `handler` returns.
+ */
+void vrts_posix_frame(uint8_t slot, void (*handler)(void), void (*finished)(void))
+{
+  ucontext_t *ctx = &posix_thread[slot];
+  posix_handler[slot] = handler;
+  posix_finished = finished;
+  getcontext(ctx);
+  ctx->uc_stack.ss_sp = posix_stack[slot];
+  ctx->uc_stack.ss_size = sizeof(posix_stack[slot]);
+  ctx->uc_link = &posix_main;
+  makecontext(ctx, (void (*)(void))VRTS_PosixEntry, 1, (int)slot);
+}
+
+/**
+ * @brief Starts scheduling from thread slot. Returns after `vrts_posix_stop()`.
+ * @param slot First thread slot index.
+ */
+void vrts_posix_start(uint8_t slot)
+{
+  swapcontext(&posix_main, &posix_thread[slot]);
+}
+
+/**
+ * @brief Switches context between thread slots (host replacement for PendSV).
+ *   With virtual clock, every `VRTS_POSIX_LETS_PER_TICK` switch raises a SysTick.
+ * @param from Slot of calling thread.
+ * @param to Slot of next thread.
+ */
+void vrts_posix_switch(uint8_t from, uint8_t to)
+{
+  posix_lets++;
+  #if(!VRTS_POSIX_REALTIME)
+    if(!(posix_lets % VRTS_POSIX_LETS_PER_TICK)) SysTick_Handler();
+  #endif
+  if(from == to) return;
+  swapcontext(&posix_thread[from], &posix_thread[to]);
+}
+
+/**
+ * @brief Leaves scheduler and resumes the `vrts_init()` caller.
+ *   Calling thread is suspended and continues if `vrts_init()` is called again.
+ */
+void vrts_posix_stop(void)
+{
+  swapcontext(&posix_thread[vrts_active_thread()], &posix_main);
+}
+
+/**
+ * @brief Waits for next SysTick (host replacement for `__WFI()`).
+ *   Virtual clock jumps straight to the next tick.
+ */
+void vrts_posix_idle(void)
+{
+  #if(VRTS_POSIX_REALTIME)
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigsuspend(&mask);
+  #else
+    SysTick_Handler();
+  #endif
+}
+
+#if(VRTS_POSIX_REALTIME)
+static void VRTS_PosixAlarm(int signal)
+{
+  (void)signal;
+  SysTick_Handler();
+}
+#endif
+
+/**
+ * @brief Starts simulated SysTick source.
+ * @param systick_ms Interval duration in milliseconds.
+ * @return `true` if timer was configured, `false` otherwise.
+ */
+bool vrts_posix_systick(uint32_t systick_ms)
+{
+  #if(VRTS_POSIX_REALTIME)
+    struct sigaction action = { 0 };
+    action.sa_handler = VRTS_PosixAlarm;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    if(sigaction(SIGALRM, &action, NULL)) return false;
+    struct itimerval timer = {
+      .it_interval = { .tv_sec = systick_ms / 1000, .tv_usec = (systick_ms % 1000) * 1000 },
+      .it_value = { .tv_sec = systick_ms / 1000, .tv_usec = (systick_ms % 1000) * 1000 }
+    };
+    return !setitimer(ITIMER_REAL, &timer, NULL);
+  #else
+    (void)systick_ms;
+    return true;
+  #endif
+}
+
+/**
+ * @brief Reports fatal scheduler error and aborts host process.
+ * @param message Error description.
+ */
+void vrts_posix_panic(const char *message)
+{
+  fprintf(stderr, "VRTS panic: %s\n", message);
+  abort();
+}
+
+/**
+ * @brief Gets number of context switches since start (for benchmarks).
+ * @return Total `let()` switch count.
+ */
+uint64_t vrts_posix_lets(void)
+{
+  return posix_lets;
+}
+
+#endif
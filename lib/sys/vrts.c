@@ -1,8 +1,23 @@
 #include "vrts.h"
-#include "log.h"
+
+#if(VRTS_POSIX)
+  #define VRTS_IDLE() vrts_posix_idle()
+  #define VRTS_PANIC(message) vrts_posix_panic(message)
+#else
+  #include "log.h"
+  #include "sys.h"
+  #include "heap.h"
+  #define VRTS_IDLE() __WFI()
+  #define VRTS_PANIC(message) panic(message LOG_LIB("VRTS"))
+#endif
 
 volatile uint64_t VrtsTicker;
 static uint32_t tick_ms; // time in ms for a single ticker tick
+static uint32_t tick_recip; // floor(2^32 / tick_ms): ms → tick conversion without division
+static uint32_t tick_us_period; // time in us for a single ticker tick
+#if(!VRTS_POSIX)
+  static uint32_t tick_us_recip; // us per SysTick cycle in Q32 (`1e6 * 2^32 / SystemCoreClock`)
+#endif
 
 volatile VRTS_Task_t *vrts_now_thread; // Current thread
 volatile VRTS_Task_t *vrts_next_thread; // Next thread
@@ -10,7 +25,6 @@ volatile VRTS_Task_t *vrts_next_thread; // Next thread
 #if(VRTS_SWITCHING)
 
 #if(VRTS_THREAD_TIMEOUT_MS)
-  #include "sys.h"
   static uint32_t hold_timeout;
   static volatile uint32_t hold_ticker;
 #endif
@@ -19,33 +33,78 @@ volatile VRTS_Task_t *vrts_next_thread; // Next thread
 struct {
   VRTS_Task_t threads[VRTS_THREAD_LIMIT];
   uint32_t i; // Active thread
-  uint32_t count; // Thread count
+  uint32_t count; // Number of used slots (free slots below `count` are reused first)
+  uint32_t alive; // Number of running threads
+  bool priorities; // Any thread with non-zero priority: use priority scheduler
   bool enabled; // Switching VRTS enabled flag
   bool init; // VRTS initialization flag
 } vrts;
 
+// Pool of stacks for one-shot worker threads
+static struct {
+  uint32_t *stack;
+  uint16_t size;
+  bool busy;
+} vrts_pool[VRTS_WORKER_LIMIT];
+static uint8_t vrts_pool_count;
+
 /**
- * @brief Handles end of thread execution
+ * @brief Handles end of thread execution.
+ * Releases thread slot (and worker stack) for reuse, then switches away for good.
+ * Context saved by the final `let()` is never restored.
  */
 static void VRTS_TaskFinished(void)
 {
-  volatile uint32_t i = 0;
-  while(1) i++;
+  VRTS_Task_t *thread = &vrts.threads[vrts.i];
+  #if(!VRTS_POSIX)
+    heap_clear(); // Free garbage-collector memory owned by this slot
+  #endif
+  if(thread->worker >= 0) vrts_pool[thread->worker].busy = false;
+  thread->active = false;
+  vrts.alive--;
+  while(1) {
+    let();
+    VRTS_IDLE(); // Only reached while switching is locked (`vrts_lock`)
+  }
 }
 
 /**
- * @brief Adds a new thread to the VRTS system
- * @param handler Function pointer to the thread's main function
- * @param stack Pointer to the memory allocated for the thread's stack
- * @param size Size of the stack in 32-bit words (minimum: 80[M0+]/128[M4])
- * @return True if the thread was successfully added, false if the thread limit is reached
+ * @brief Entry point of worker thread: runs one-shot job and returns to `VRTS_TaskFinished`.
  */
-bool vrts_thread(void (*handler)(void), uint32_t *stack, uint16_t size)
+static void VRTS_WorkerEntry(void)
 {
-  if(vrts.count >= VRTS_THREAD_LIMIT - 1) return false;
-  VRTS_Task_t *thread = &vrts.threads[vrts.count];
+  VRTS_Task_t *thread = &vrts.threads[vrts.i];
+  thread->job(thread->arg);
+}
+
+/**
+ * @brief Finds free thread slot, reusing released ones before growing `count`.
+ * @return Slot index, or `-1` if thread limit is reached.
+ */
+static int32_t VRTS_FreeSlot(void)
+{
+  for(uint32_t i = 0; i < vrts.count; i++) {
+    if(!vrts.threads[i].active) return i;
+  }
+  if(vrts.count >= VRTS_THREAD_LIMIT - 1) return -1;
+  return vrts.count;
+}
+
+/**
+ * @brief Prepares initial stack frame of thread in given slot and marks it active.
+ * @param slot Thread slot index.
+ * @param handler Thread main function.
+ * @param stack Pointer to the memory allocated for the thread's stack.
+ * @param size Size of the stack in 32-bit words.
+ */
+static void VRTS_Frame(uint32_t slot, void (*handler)(void), uint32_t *stack, uint16_t size)
+{
+  VRTS_Task_t *thread = &vrts.threads[slot];
   thread->handler = handler;
-  #if(VRTS_CORE_M4)
+  #if(VRTS_POSIX)
+    (void)stack; (void)size;
+    vrts_posix_frame(slot, handler, &VRTS_TaskFinished);
+  #elif(VRTS_CORE_M4)
     thread->stack = (uint32_t)(stack + size - 17);
     stack[size - 1] = (1 << 24); // XPSR: Default value
     stack[size - 2] = (uint32_t)handler; // PC: Point to the handler function
@@ -60,7 +119,145 @@ bool vrts_thread(void (*handler)(void), uint32_t *stack, uint16_t size)
     stack[size - 3] = (uint32_t)&VRTS_TaskFinished;
   #endif
   // Next: R12, R3, R2, R1, R0, R7, R6, R5, R4, R11, R10, R9, R8
-  vrts.count++;
+  thread->wake = 0;
+  thread->block = NULL;
+  thread->active = true;
+  if(slot == vrts.count) vrts.count++;
+  vrts.alive++;
+}
+
+/**
+ * @brief Adds a new thread to the VRTS system
+ * A thread whose handler returns is reaped and its slot is reused by later threads.
+ * @param handler Function pointer to the thread's main function
+ * @param stack Pointer to the memory allocated for the thread's stack
+ * @param size Size of the stack in 32-bit words (minimum: 80[M0+]/128[M4])
+ * @return True if the thread was successfully added, false if the thread limit is reached
+ */
+bool vrts_thread(void (*handler)(void), uint32_t *stack, uint16_t size)
+{
+  return vrts_thread_priority(handler, stack, size, 0);
+}
+
+/**
+ * @brief Adds a new thread with static priority to the VRTS system
+ * The highest-priority ready thread runs first, threads of equal priority take turns.
+ * A thread is ready unless it is parked in `delay`, `delay_until` or a periodic wait.
+ * Polling waits (`wait_for`, `timeout`, `let_poll`) park it for one tick between checks,
+ * while a bare `while(...) let()` loop keeps it ready and starves all lower levels.
+ * @param handler Function pointer to the thread's main function
+ * @param stack Pointer to the memory allocated for the thread's stack
+ * @param size Size of the stack in 32-bit words (minimum: 80[M0+]/128[M4])
+ * @param priority Thread priority, `0` is the lowest (default of `vrts_thread`)
+ * @return True if the thread was successfully added, false if the thread limit is reached
+ */
+bool vrts_thread_priority(void (*handler)(void), uint32_t *stack, uint16_t size, uint8_t priority)
+{
+  int32_t slot = VRTS_FreeSlot();
+  if(slot < 0) return false;
+  vrts.threads[slot].job = NULL;
+  vrts.threads[slot].worker = -1;
+  vrts.threads[slot].priority = priority;
+  if(priority) vrts.priorities = true;
+  VRTS_Frame(slot, handler, stack, size);
+  return true;
+}
+
+/**
+ * @brief Entry point of periodic thread: releases handler on exact period boundaries
+ * and records start jitter relative to each boundary.
+ */
+static void VRTS_PeriodicEntry(void)
+{
+  VRTS_Periodic_t *periodic = vrts.threads[vrts.i].arg;
+  uint32_t period = tick_span(periodic->period_ms);
+  if(!period) period = 1;
+  periodic->release = tick_read();
+  periodic->jitter_min = UINT32_MAX;
+  while(1) {
+    uint64_t start = tick_us();
+    uint64_t boundary = periodic->release * tick_us_period;
+    uint32_t jitter = start > boundary ? (uint32_t)(start - boundary) : 0;
+    if(jitter < periodic->jitter_min) periodic->jitter_min = jitter;
+    if(jitter > periodic->jitter_max) periodic->jitter_max = jitter;
+    periodic->jitter_sum += jitter;
+    periodic->handler();
+    periodic->count++;
+    periodic->release += period;
+    uint64_t now = tick_read();
+    while(periodic->release <= now) { // Boundary already passed: skip missed releases
+      periodic->release += period;
+      periodic->overruns++;
+    }
+    uint64_t release = periodic->release;
+    delay_until(&release);
+  }
+}
+
+/**
+ * @brief Adds a periodic thread that calls `periodic->handler` every `periodic->period_ms`
+ * Releases are anchored to the first one, so there is no drift; statistics of start
+ * jitter and overruns are kept in `periodic`.
+ * @param periodic Pointer to periodic descriptor with `handler` and `period_ms` set
+ * @param stack Pointer to the memory allocated for the thread's stack
+ * @param size Size of the stack in 32-bit words (minimum: 80[M0+]/128[M4])
+ * @param priority Thread priority, usually higher for shorter periods (rate-monotonic)
+ * @return True if the thread was successfully added, false if the thread limit is reached
+ */
+bool vrts_periodic(VRTS_Periodic_t *periodic, uint32_t *stack, uint16_t size, uint8_t priority)
+{
+  int32_t slot = VRTS_FreeSlot();
+  if(slot < 0) return false;
+  vrts.threads[slot].job = NULL;
+  vrts.threads[slot].arg = periodic;
+  vrts.threads[slot].worker = -1;
+  vrts.threads[slot].priority = priority;
+  if(priority) vrts.priorities = true;
+  VRTS_Frame(slot, &VRTS_PeriodicEntry, stack, size);
+  return true;
+}
+
+/**
+ * @brief Adds a pre-allocated stack to the worker pool used by `vrts_spawn`.
+ * @param stack Pointer to the memory allocated for the worker's stack
+ * @param size Size of the stack in 32-bit words (minimum: 80[M0+]/128[M4])
+ * @return True if the stack was added, false if `VRTS_WORKER_LIMIT` is reached
+ */
+bool vrts_worker(uint32_t *stack, uint16_t size)
+{
+  if(vrts_pool_count >= VRTS_WORKER_LIMIT) return false;
+  vrts_pool[vrts_pool_count].stack = stack;
+  vrts_pool[vrts_pool_count].size = size;
+  vrts_pool[vrts_pool_count].busy = false;
+  vrts_pool_count++;
+  return true;
+}
+
+/**
+ * @brief Runs one-shot job in a new thread on a free worker-pool stack.
+ * Thread starts on the next scheduler round. When `job` returns,
+ * its slot and stack go back to the pool.
+ * @param job Function to run, receives `arg`
+ * @param arg User pointer passed to `job`
+ * @return True if job was started, false if no worker stack or thread slot is free
+ */
+bool vrts_spawn(void (*job)(void *), void *arg)
+{
+  int8_t worker = -1;
+  for(uint8_t i = 0; i < vrts_pool_count; i++) {
+    if(!vrts_pool[i].busy) {
+      worker = i;
+      break;
+    }
+  }
+  if(worker < 0) return false;
+  int32_t slot = VRTS_FreeSlot();
+  if(slot < 0) return false;
+  vrts_pool[worker].busy = true;
+  vrts.threads[slot].job = job;
+  vrts.threads[slot].arg = arg;
+  vrts.threads[slot].worker = worker;
+  VRTS_Frame(slot, &VRTS_WorkerEntry, vrts_pool[worker].stack, vrts_pool[worker].size);
   return true;
 }
 
@@ -69,18 +266,26 @@ bool vrts_thread(void (*handler)(void), uint32_t *stack, uint16_t size)
  */
 void vrts_init(void)
 {
-  NVIC_SetPriority(PendSV_IRQn, 3);
   vrts_now_thread = &vrts.threads[vrts.i];
-  #if(VRTS_CORE_M4)
-    __set_PSP(vrts_now_thread->stack + 68); // Set PSP to the top of thread's stack
+  #if(VRTS_POSIX)
+    vrts.enabled = true;
+    vrts.init = true;
+    vrts_posix_start(vrts.i); // Returns after `vrts_posix_stop()`
+    vrts.enabled = false;
+    vrts.init = false;
   #else
-    __set_PSP(vrts_now_thread->stack + 64); // Set PSP to the top of thread's stack
+    NVIC_SetPriority(PendSV_IRQn, 3);
+    #if(VRTS_CORE_M4)
+      __set_PSP(vrts_now_thread->stack + 68); // Set PSP to the top of thread's stack
+    #else
+      __set_PSP(vrts_now_thread->stack + 64); // Set PSP to the top of thread's stack
+    #endif
+    __set_CONTROL(0x02); // Switch to PSP, privileged mode
+    __ISB(); // Exec. ISB after changing CONTORL (recommended)
+    vrts.enabled = true;
+    vrts.init = true;
+    vrts_now_thread->handler();
   #endif
-  __set_CONTROL(0x02); // Switch to PSP, privileged mode
-  __ISB(); // Exec. ISB after changing CONTORL (recommended)
-  vrts.enabled = true;
-  vrts.init = true;
-  vrts_now_thread->handler();
 }
 
 /** @brief Disables thread switching by setting the enabled flag to false */
@@ -100,6 +305,62 @@ bool vrts_unlock(void)
   return true;
 }
 
+/**
+ * @brief Picks the next thread to run, skipping threads parked (`wake`) or blocked (`block`).
+ * Without priorities: next ready slot (round-robin).
+ * With priorities: highest-priority ready thread, round-robin within a level.
+ * @return Index of next thread, `-1` if no thread is ready
+ */
+static int32_t VRTS_Next(void)
+{
+  uint64_t now = tick_read();
+  uint32_t i = vrts.i;
+  int32_t best = -1;
+  for(uint32_t n = 0; n < vrts.count; n++) { // Current thread is checked last
+    i++;
+    if(i >= vrts.count)
+      i = 0;
+    VRTS_Task_t *thread = &vrts.threads[i];
+    if(!thread->active || thread->wake > now) continue;
+    if(thread->block && (!thread->block_end || thread->block_end > now)) continue;
+    if(!vrts.priorities) return i;
+    if(best < 0 || thread->priority > vrts.threads[best].priority) best = i;
+  }
+  return best;
+}
+
+/**
+ * @brief Picks the next thread, idling the core until an interrupt makes one ready.
+ * Readiness is checked with interrupts disabled, so a wake-up cannot slip in before `WFI`
+ * (a pending interrupt ends `WFI` even when masked and runs once they are enabled).
+ * @return Index of next thread
+ */
+static uint32_t VRTS_Ready(void)
+{
+  int32_t next = VRTS_Next();
+  if(next >= 0) return next;
+  __disable_irq();
+  while((next = VRTS_Next()) < 0) {
+    #if(VRTS_THREAD_TIMEOUT_MS)
+      hold_ticker = hold_timeout; // Idle time is not held by any thread
+    #endif
+    VRTS_IDLE();
+    __enable_irq();
+    __disable_irq();
+  }
+  __enable_irq();
+  return next;
+}
+
+/**
+ * @brief Marks calling thread as parked until `tick`, the scheduler skips it until then.
+ * @param tick Wake-up tick, `0` if ready
+ */
+static inline void VRTS_Park(uint64_t tick)
+{
+  vrts.threads[vrts.i].wake = tick;
+}
+
 /**
  * @brief Yields control to the next thread in the schedule
  */
@@ -107,20 +368,84 @@ void let(void)
 {
   if(!vrts.enabled) return;
   vrts_now_thread = &vrts.threads[vrts.i];
-  vrts.i++;
-  if(vrts.i >= vrts.count)
-    vrts.i = 0;
+  vrts.i = VRTS_Ready();
   vrts_next_thread = &vrts.threads[vrts.i];
   #if(VRTS_THREAD_TIMEOUT_MS)
     hold_ticker = hold_timeout;
   #endif
-  SCB->ICSR |= SCB_ICSR_PENDSVSET_Msk;
+  #if(VRTS_POSIX)
+    vrts_posix_switch(vrts_now_thread - vrts.threads, vrts.i);
+  #else
+    SCB->ICSR |= SCB_ICSR_PENDSVSET_Msk;
+  #endif
+}
+
+/**
+ * @brief Blocks calling thread on `object` until `vrts_notify(object)` or tick `end`.
+ * Thread is skipped by the scheduler from its next `let()`. Caller checks its
+ * wake-up condition and calls this with interrupts disabled, so a notify cannot slip
+ * in between, then yields and calls `vrts_block(NULL, 0)` when it runs again.
+ * @param object Wait object (any address shared with the notifier), `NULL` to unblock
+ * @param end Timeout tick, `0` for none
+ */
+void vrts_block(const void *object, uint64_t end)
+{
+  VRTS_Task_t *thread = &vrts.threads[vrts.i];
+  thread->block_end = end;
+  thread->block = object;
+}
+
+/**
+ * @brief Releases all threads blocked on `object`. Safe to call from interrupts.
+ * @param object Wait object passed to `vrts_block`
+ */
+void vrts_notify(const void *object)
+{
+  for(uint32_t i = 0; i < vrts.count; i++) {
+    if(vrts.threads[i].block == object) vrts.threads[i].block = NULL;
+  }
+}
+
+/**
+ * @brief Yields from a polling loop.
+ * Under priority scheduling a ready thread above the lowest level would be picked again
+ * right away, so it is parked until the next tick and lower levels run in between.
+ */
+void let_poll(void)
+{
+  if(!vrts.priorities || !vrts.threads[vrts.i].priority) {
+    let();
+    return;
+  }
+  VRTS_Park(tick_read() + 1);
+  let();
+  VRTS_Park(0);
 }
 
 #else
 void let(void)
 {
-  __WFI();
+  VRTS_IDLE();
+}
+
+void let_poll(void)
+{
+  VRTS_IDLE();
+}
+
+void vrts_block(const void *object, uint64_t end)
+{
+  (void)object; (void)end;
+}
+
+void vrts_notify(const void *object)
+{
+  (void)object;
+}
+
+static inline void VRTS_Park(uint64_t tick)
+{
+  (void)tick;
 }
 #endif
 
@@ -137,6 +462,19 @@ uint8_t vrts_active_thread(void)
   #endif
 }
 
+/**
+ * @brief Gets the number of running threads
+ * @return Count of active (not finished) threads
+ */
+uint8_t vrts_thread_count(void)
+{
+  #if(VRTS_SWITCHING)
+    return vrts.alive;
+  #else
+    return 1;
+  #endif
+}
+
 /**
  * @brief Returns the adjusted system tick with an offset.
  * @param offset_ms Milliseconds to add to the current tick.
@@ -145,7 +483,36 @@ uint8_t vrts_active_thread(void)
  */
 uint64_t tick_keep(uint32_t offset_ms)
 {
-  return VrtsTicker + ((offset_ms + (tick_ms - 1)) / tick_ms);
+  return tick_read() + tick_span(offset_ms);
+}
+
+/**
+ * @brief Converts milliseconds to number of ticks, rounded up. Does not read the clock.
+ * @param ms Time in milliseconds.
+ * @return Number of ticks.
+ */
+uint32_t tick_span(uint32_t ms)
+{
+  if(tick_ms <= 1) return ms;
+  // ceil(ms / tick_ms) by reciprocal multiply, estimate is exact or one too small
+  uint32_t ticks = (uint32_t)(((uint64_t)ms * tick_recip) >> 32);
+  uint32_t rest = ms - ticks * tick_ms;
+  if(rest >= tick_ms) {
+    ticks++;
+    rest -= tick_ms;
+  }
+  if(rest) ticks++;
+  return ticks;
+}
+
+/**
+ * @brief Converts ticks to milliseconds (wraps after 2^32 ms, about 49 days).
+ * @param tick Tick value, e.g. from `tick_now()`.
+ * @return Time in milliseconds.
+ */
+uint32_t tick_to_ms(uint64_t tick)
+{
+  return (uint32_t)tick * tick_ms;
 }
 
 /**
@@ -153,9 +520,35 @@ uint64_t tick_keep(uint32_t offset_ms)
  * @return Current tick value.
  * @note Working with 'tick_over', 'tick_away', 'tick_diff', 'delay_until', 'sleep_until' functions.
  */
-inline uint64_t tick_now(void)
+uint64_t tick_now(void)
 {
-  return tick_keep(0);
+  return tick_read();
+}
+
+/**
+ * @brief Returns monotonic time in microseconds since SysTick start.
+ * Sub-tick part is interpolated from `SysTick->VAL` (tick resolution only on the host port).
+ * @note Call with interrupts enabled: a SysTick held off by a masked context for longer
+ *   than one period cannot be accounted for.
+ * @return Current time in microseconds.
+ */
+uint64_t tick_us(void)
+{
+  #if(VRTS_POSIX)
+    return tick_read() * tick_us_period;
+  #else
+    uint64_t tick;
+    uint32_t val, pending;
+    do {
+      tick = tick_read();
+      val = SysTick->VAL;
+      pending = SCB->ICSR & SCB_ICSR_PENDSTSET_Msk;
+    } while(tick != tick_read());
+    uint32_t load = SysTick->LOAD;
+    if(pending && val > (load >> 1)) tick++; // Counter wrapped, handler not served yet
+    uint32_t cycles = load - val;
+    return tick * tick_us_period + (uint32_t)(((uint64_t)cycles * tick_us_recip) >> 32);
+  #endif
 }
 
 /**
@@ -165,7 +558,7 @@ inline uint64_t tick_now(void)
  */
 bool tick_over(uint64_t *tick)
 {
-  if(!*tick || *tick > VrtsTicker) return false;
+  if(!*tick || *tick > tick_read()) return false;
   *tick = 0;
   return true;
 }
@@ -178,7 +571,7 @@ bool tick_over(uint64_t *tick)
 bool tick_away(uint64_t *tick)
 {
   if(!*tick) return false;
-  if(*tick > VrtsTicker) return true;
+  if(*tick > tick_read()) return true;
   *tick = 0;
   return false;
 }
@@ -190,7 +583,7 @@ bool tick_away(uint64_t *tick)
  */
 int32_t tick_diff(uint64_t tick)
 {
-  return (int32_t)(((int64_t)VrtsTicker - tick) * tick_ms) ;
+  return (int32_t)(((int64_t)tick_read() - tick) * tick_ms);
 }
 
 /** 
@@ -201,7 +594,9 @@ int32_t tick_diff(uint64_t tick)
 void delay(uint32_t ms)
 {
   uint64_t end = tick_keep(ms);
-  while(end > VrtsTicker) let();
+  VRTS_Park(end);
+  while(end > tick_read()) let();
+  VRTS_Park(0);
 }
 
 /** 
@@ -212,11 +607,12 @@ void delay(uint32_t ms)
 void sleep(uint32_t ms)
 {
   uint64_t end = tick_keep(ms);
-  while(end > VrtsTicker) __WFI();
+  while(end > tick_read()) VRTS_IDLE();
 }
 
 /**
  * @brief Checks a condition repeatedly until timeout or condition met
+ * Uses `let_poll()`, so a high-priority caller does not starve lower levels.
  * @param ms Timeout duration in milliseconds
  * @param Free Function pointer that checks the condition
  * @param subject Pointer to data for condition checking
@@ -225,11 +621,11 @@ void sleep(uint32_t ms)
 bool timeout(uint32_t ms, bool (*Free)(void *), void *subject)
 {
   uint64_t end = tick_keep(ms);
-  while(end > VrtsTicker) {
+  while(end > tick_read()) {
     if(Free(subject)) {
       return false;
     }
-    let();
+    let_poll();
   }
   return true;
 }
@@ -242,7 +638,9 @@ bool timeout(uint32_t ms, bool (*Free)(void *), void *subject)
 void delay_until(uint64_t *tick)
 {
   if(!*tick) return;
-  while(*tick > VrtsTicker) let();
+  VRTS_Park(*tick);
+  while(*tick > tick_read()) let();
+  VRTS_Park(0);
   *tick = 0;
 }
 
@@ -254,7 +652,7 @@ void delay_until(uint64_t *tick)
 void sleep_until(uint64_t *tick)
 {
   if(!*tick) return;
-  while(*tick > VrtsTicker) __WFI();
+  while(*tick > tick_read()) VRTS_IDLE();
   *tick = 0;
 }
 
@@ -266,19 +664,27 @@ void sleep_until(uint64_t *tick)
  */
 bool systick_init(uint32_t systick_ms)
 {
+  if(!systick_ms) return false;
   tick_ms = systick_ms;
-  uint32_t overflow = (uint32_t)((float)tick_ms * SystemCoreClock / 1000);
+  tick_recip = UINT32_MAX / systick_ms; // One division here, none in `tick_keep`
+  tick_us_period = 1000 * systick_ms;
   #if(VRTS_SWITCHING && VRTS_THREAD_TIMEOUT_MS)
     hold_timeout = VRTS_THREAD_TIMEOUT_MS / systick_ms;
     hold_ticker = hold_timeout;
   #endif
-  if(SysTick_Config(overflow)) return false;
-  #if(VRTS_CORE_M4)
-    NVIC_SetPriority(SysTick_IRQn, 0x0F);
+  #if(VRTS_POSIX)
+    return vrts_posix_systick(systick_ms);
   #else
-    NVIC_SetPriority(SysTick_IRQn, 3);
+    uint32_t overflow = (uint32_t)((float)tick_ms * SystemCoreClock / 1000);
+    if(SysTick_Config(overflow)) return false;
+    tick_us_recip = (uint32_t)((1000000ull << 32) / SystemCoreClock);
+    #if(VRTS_CORE_M4)
+      NVIC_SetPriority(SysTick_IRQn, 0x0F);
+    #else
+      NVIC_SetPriority(SysTick_IRQn, 3);
+    #endif
+    return true;
   #endif
-  return true;
 }
 
 /** @brief SysTick interrupt handler to increment the global `VrtsTicker` */
@@ -288,7 +694,7 @@ void SysTick_Handler(void)
   #if(VRTS_SWITCHING && VRTS_THREAD_TIMEOUT_MS)
   if(vrts.init) {
     hold_ticker--;
-    if(!hold_ticker) panic("Thread overran core time limit" LOG_LIB("VRTS"));
+    if(!hold_ticker) VRTS_PANIC("Thread overran core time limit");
   }
   #endif
 }
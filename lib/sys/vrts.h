@@ -14,9 +14,17 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <string.h>
-#include "stm32g0xx.h"
 #include "main.h"
 
+// Host build: threads on `ucontext`, SysTick simulated (see `vrts-posix.c`)
+#ifndef VRTS_POSIX
+  #define VRTS_POSIX 0
+#endif
+
+#if(!VRTS_POSIX)
+  #include "stm32g0xx.h"
+#endif
+
 #define VRTS_CORE_M4 0 // Cores without a floating-point unit
 
 // Max number of threads if not defined
@@ -29,6 +37,11 @@
   #define VRTS_SWITCHING 1 
 #endif
 
+// Number of pre-allocated stacks for one-shot worker threads (`vrts_spawn`)
+#ifndef VRTS_WORKER_LIMIT
+  #define VRTS_WORKER_LIMIT 4
+#endif
+
 // Maximum time a thread is allowed to hold the CPU core
 #ifndef VRTS_THREAD_TIMEOUT_MS
   #define VRTS_THREAD_TIMEOUT_MS 2000
@@ -37,21 +50,86 @@
 #define WAIT_ (bool (*)(void *)) // Type cast for timeout function
 #define seconds(ms)  (1000 * ms) // Convert seconds to milliseconds
 #define minutes(min) (60 * 1000 * min) // Convert minutes to milliseconds
-#define wait_for(flag) while(!(flag)) let() // Wait until `flag` is `true`
+#define wait_for(flag) while(!(flag)) let_poll() // Wait until `flag` is `true`
 
-// Struct to represent a thread in VRTS
+/**
+ * @brief Struct to represent a thread in VRTS.
+ * @param stack Saved stack pointer (must stay first, used by PendSV).
+ * @param handler Thread main function.
+ * @param job One-shot job of worker thread, `NULL` for regular threads.
+ * @param arg Argument passed to `job`.
+ * @param worker Index of pool stack used by worker thread, `-1` for regular threads.
+ * @param active `true` while slot holds a running thread, `false` when free for reuse.
+ * @param priority Static priority, higher runs first (`0` for all threads = plain round-robin).
+ * @param wake Tick before which a parked thread is skipped by the scheduler, `0` if ready.
+ * @param block Object the thread is blocked on (`vrts_block`), `NULL` if none.
+ * @param block_end Tick at which blocking wait times out, `0` for no timeout.
+ */
 typedef struct {
   volatile uint32_t stack;
   void (*handler)(void);
+  void (*job)(void *);
+  void *arg;
+  int8_t worker;
+  bool active;
+  uint8_t priority;
+  uint64_t wake;
+  const void *volatile block;
+  uint64_t block_end;
 } VRTS_Task_t;
 
+/**
+ * @brief Periodic thread released at exact period boundaries (rate-monotonic use).
+ * @param[in] handler Function called once per period (must return).
+ * @param[in] period_ms Release period in milliseconds.
+ * @param release Tick of next release. [internal]
+ * @param count Number of completed releases.
+ * @param overruns Number of releases missed because `handler` ran past the next boundary.
+ * @param jitter_min Smallest start delay after release boundary in microseconds.
+ * @param jitter_max Largest start delay after release boundary in microseconds.
+ * @param jitter_sum Sum of start delays in microseconds (average = `jitter_sum / count`).
+ */
+typedef struct {
+  void (*handler)(void);
+  uint32_t period_ms;
+  uint64_t release;
+  uint32_t count;
+  uint32_t overruns;
+  uint32_t jitter_min;
+  uint32_t jitter_max;
+  uint64_t jitter_sum;
+} VRTS_Periodic_t;
+
+extern volatile uint64_t VrtsTicker;
+
+/**
+ * @brief Reads `VrtsTicker` without tearing against `SysTick_Handler`.
+ * On Cortex-M0+ a 64-bit load is two 32-bit loads, so the high word is read again
+ * and the snapshot is retried if a carry happened in between.
+ * @return Current tick value.
+ */
+static inline uint64_t tick_read(void)
+{
+  volatile uint32_t *word = (volatile uint32_t *)&VrtsTicker;
+  uint32_t high, low;
+  do {
+    high = word[1];
+    low = word[0];
+  } while(high != word[1]);
+  return ((uint64_t)high << 32) | low;
+}
+
 uint64_t tick_keep(uint32_t offset_ms);
+uint32_t tick_span(uint32_t ms);
+uint32_t tick_to_ms(uint64_t tick);
 uint64_t tick_now(void);
+uint64_t tick_us(void);
 bool tick_over(uint64_t *tick);
 bool tick_away(uint64_t *tick);
 int32_t tick_diff(uint64_t tick);
 void let(void);
 #define yield let
+void let_poll(void);
 void delay(uint32_t ms);
 void sleep(uint32_t ms);
 bool timeout(uint32_t ms, bool (*Free)(void *), void *subject);
@@ -59,15 +137,64 @@ void delay_until(uint64_t *tick);
 void sleep_until(uint64_t *tick);
 
 bool vrts_thread(void (*handler)(void), uint32_t *stack, uint16_t size);
+bool vrts_thread_priority(void (*handler)(void), uint32_t *stack, uint16_t size, uint8_t priority);
 #define stack(name, size) static uint32_t name[8 * ((size + 7) / 8)] __attribute__((aligned(8)))
 #define thread(fnc, stack_name) vrts_thread(&fnc, (uint32_t *)stack_name, sizeof(stack_name) / sizeof(uint32_t));
+#define thread_priority(fnc, stack_name, priority) \
+  vrts_thread_priority(&fnc, (uint32_t *)stack_name, sizeof(stack_name) / sizeof(uint32_t), priority);
+bool vrts_periodic(VRTS_Periodic_t *periodic, uint32_t *stack, uint16_t size, uint8_t priority);
+#define thread_periodic(periodic, stack_name, priority) \
+  vrts_periodic(&periodic, (uint32_t *)stack_name, sizeof(stack_name) / sizeof(uint32_t), priority);
+bool vrts_worker(uint32_t *stack, uint16_t size);
+#define worker(stack_name) vrts_worker((uint32_t *)stack_name, sizeof(stack_name) / sizeof(uint32_t));
+bool vrts_spawn(void (*job)(void *), void *arg);
+#define spawn(fnc, arg) vrts_spawn((void (*)(void *))&fnc, (void *)(arg))
+
+void vrts_block(const void *object, uint64_t end);
+void vrts_notify(const void *object);
 
 void vrts_init(void);
 void vrts_lock(void);
 bool vrts_unlock(void);
 uint8_t vrts_active_thread(void);
+uint8_t vrts_thread_count(void);
 bool systick_init(uint32_t systick_ms);
 
-extern volatile uint64_t VrtsTicker;
+
+//------------------------------------------------------------------------------------------------- POSIX
+
+#if(VRTS_POSIX)
+
+// Host SysTick source: `0` virtual clock (deterministic), `1` POSIX interval timer (wall time)
+#ifndef VRTS_POSIX_REALTIME
+  #define VRTS_POSIX_REALTIME 0
+#endif
+
+// Virtual clock: number of `let()` calls that make up one SysTick period
+#ifndef VRTS_POSIX_LETS_PER_TICK
+  #define VRTS_POSIX_LETS_PER_TICK 16
+#endif
+
+// Host stack size in bytes for each thread slot (user `stack()` buffers are too small for libc)
+#ifndef VRTS_POSIX_STACK_SIZE
+  #define VRTS_POSIX_STACK_SIZE 65536
+#endif
+
+// CMSIS interrupt masking: no-ops, the simulated SysTick only advances `VrtsTicker`
+static inline uint32_t __get_PRIMASK(void) { return 0; }
+static inline void __set_PRIMASK(uint32_t primask) { (void)primask; }
+static inline void __disable_irq(void) {}
+static inline void __enable_irq(void) {}
+
+void vrts_posix_frame(uint8_t slot, void (*handler)(void), void (*finished)(void));
+void vrts_posix_start(uint8_t slot);
+void vrts_posix_switch(uint8_t from, uint8_t to);
+void vrts_posix_stop(void);
+void vrts_posix_idle(void);
+bool vrts_posix_systick(uint32_t systick_ms);
+void vrts_posix_panic(const char *message);
+uint64_t vrts_posix_lets(void);
+
+#endif
 
 #endif
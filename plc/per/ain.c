@@ -38,8 +38,7 @@ float AIN_Raw(AIN_t *ain)
 {
   if(tick_over(&ain->tick)) return ain->value;
   uint16_t size = ain->count / 3;
-  sort_asc_u16(ain->data, ain->count);
-  ain->value = avg_u16(&(ain->data[size]), size);
+  ain->value = avg_rank_u16(ain->data, ain->count, size, 2 * size); // Average of middle third
   ain->tick = tick_keep(AIN_AVERAGE_TIME_ms / 2);
   LOG_Debug("Analog input %s raw-value: %F", ain->name, ain->value);
   return ain->value;
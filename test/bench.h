@@ -0,0 +1,88 @@
+/**
+ * @file  bench.h
+ * @brief Time source and table output shared by benchmarks that also run on the target.
+ *        Host: `bench_now()` counts nanoseconds (`clock_gettime`), text goes to `stdout`.
+ *        Target (`OpenCPLC`): `bench_now()` counts core cycles from `VrtsTicker` and `SysTick->VAL`
+ *        (Cortex-M0+ has no DWT cycle counter), text goes to the debug port.
+ *        Measured code must not call `let()`, cycles of interrupts served meanwhile are included.
+ */
+
+#ifndef BENCH_H_
+#define BENCH_H_
+
+#include <stdint.h>
+
+#ifdef OpenCPLC
+
+#include "vrts.h"
+#include "dbg.h"
+
+#define BENCH_UNIT "cycles"
+
+/**
+ * @brief Core cycles since SysTick start.
+ *   Same snapshot as `tick_us`: tick and counter are read again if a SysTick came in between.
+ * @return Cycle count.
+ */
+static inline uint64_t bench_now(void)
+{
+  uint64_t tick;
+  uint32_t val, pending;
+  do {
+    tick = tick_read();
+    val = SysTick->VAL;
+    pending = SCB->ICSR & SCB_ICSR_PENDSTSET_Msk;
+  } while(tick != tick_read());
+  uint32_t load = SysTick->LOAD;
+  if(pending && val > (load >> 1)) tick++; // Counter wrapped, handler not served yet
+  return tick * (load + 1) + (load - val);
+}
+
+static inline void bench_text(const char *text)
+{
+  DBG_String((char *)text);
+}
+
+static inline void bench_value(double value)
+{
+  DBG_Float((float)value, 1);
+}
+
+// Lets `DBG_Loop` send the table line by line, debug buffer is smaller than the whole table
+static inline void bench_flush(void)
+{
+  delay(20);
+}
+
+#else
+
+#include <stdio.h>
+#include <time.h>
+
+#define BENCH_UNIT "ns"
+
+static inline uint64_t bench_now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static inline void bench_text(const char *text)
+{
+  fputs(text, stdout);
+}
+
+static inline void bench_value(double value)
+{
+  printf("%.1f", value);
+}
+
+static inline void bench_flush(void)
+{
+  fflush(stdout);
+}
+
+#endif
+
+#endif
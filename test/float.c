@@ -0,0 +1,168 @@
+/**
+ * @file  float.c
+ * @brief Host test of `FILE_Float` (integer scaling of mantissa, no soft-float loops).
+ *        Output must equal `snprintf("%*.*f")` for 20M random finite floats (all exponents,
+ *        denormals, `-0`, values beyond 2^64), accuracy 0…9 and width 0…13.
+ *        Also checks NaN/Inf text, full buffer and locked file.
+ *        Then prints conversion time next to the previous version (multiply by 10 per decimal
+ *        digit in `float`, kept here as reference). On target, add this file to a PLC project
+ *        and call `float_bench()` from a thread: the table comes out on the debug port in
+ *        core cycles per conversion, where every `float` multiply is a soft-float call.
+ *
+ *   gcc -std=gnu11 -O2 -Itest -Ilib/ext -DFILE_PRINT_NAN_INF=1 test/float.c lib/ext/file.c lib/ext/extstr.c lib/ext/extmath.c lib/ext/heap.c -lm -o float && ./float
+ */
+
+#include <stdlib.h>
+#include "file.h"
+#include "bench.h"
+
+#ifndef OpenCPLC
+
+#include <math.h>
+
+static uint64_t state = 88172645463325252ull;
+
+static uint64_t xorshift(void)
+{
+  state ^= state << 13;
+  state ^= state >> 7;
+  state ^= state << 17;
+  return state;
+}
+
+static uint8_t buffer[256];
+static FILE_t file = { .name = "float", .buffer = buffer, .limit = 200 };
+
+static const char *print(float nbr, uint8_t accuracy, uint8_t width)
+{
+  file.size = 0;
+  int32_t n = FILE_Float(&file, nbr, accuracy, width);
+  buffer[n] = '\0';
+  return (char *)buffer;
+}
+
+#endif
+
+//------------------------------------------------------------------------------------------------- reference
+
+// Previous `FILE_Float` for finite values: `accuracy` float multiplies, then `int32_t` formatting
+static int32_t float_reference(FILE_t *file, float nbr, uint8_t accuracy, uint8_t fill_space)
+{
+  char text[40];
+  if(file->lock) return 0;
+  for(uint16_t i = 0; i < accuracy; i++) nbr *= 10;
+  if(!fill_space) fill_space = 1;
+  int32_t length = (int32_t)itoa_encode((int32_t)nbr, text, 10, true, nbr < 0 ? accuracy + 2 : accuracy + 1, fill_space - 1);
+  int32_t n = length + (accuracy ? 1 : 0);
+  if(file->size + n > file->limit) return 0;
+  for(int32_t i = 0; i < length; i++) {
+    if(accuracy && length - i == accuracy) file->buffer[file->size++] = '.';
+    file->buffer[file->size++] = text[i];
+  }
+  return n;
+}
+
+//------------------------------------------------------------------------------------------------- benchmark
+
+#define FLOAT_BENCH_COUNT 256
+#ifdef OpenCPLC
+  #define FLOAT_BENCH_REPEAT 4
+#else
+  #define FLOAT_BENCH_REPEAT 2000
+#endif
+
+static float bench_values[FLOAT_BENCH_COUNT];
+static uint8_t bench_buffer[64];
+static FILE_t bench_file = { .name = "bench", .buffer = bench_buffer, .limit = 64 };
+static volatile int32_t bench_sink;
+
+/**
+ * @brief Formats `FLOAT_BENCH_COUNT` values below `range` with `accuracy` digits, best of 3 runs.
+ * @return Time per conversion in `BENCH_UNIT`.
+ */
+static double float_bench_run(float range, uint8_t accuracy, bool reference)
+{
+  for(int i = 0; i < FLOAT_BENCH_COUNT; i++) bench_values[i] = range * ((float)rand() / RAND_MAX * 2 - 1);
+  uint64_t best = UINT64_MAX;
+  for(int run = 0; run < 3; run++) {
+    int32_t sum = 0;
+    uint64_t start = bench_now();
+    for(int r = 0; r < FLOAT_BENCH_REPEAT; r++) {
+      for(int i = 0; i < FLOAT_BENCH_COUNT; i++) {
+        bench_file.size = 0;
+        if(reference) sum += float_reference(&bench_file, bench_values[i], accuracy, 0);
+        else sum += FILE_Float(&bench_file, bench_values[i], accuracy, 0);
+      }
+    }
+    uint64_t time = bench_now() - start;
+    bench_sink = sum;
+    if(time < best) best = time;
+  }
+  return (double)best / ((double)FLOAT_BENCH_REPEAT * FLOAT_BENCH_COUNT);
+}
+
+/**
+ * @brief Prints time per `FILE_Float` conversion against the previous version (host: ns, target: core cycles).
+ *   Ranges keep `value * 10^accuracy` within `int32_t`, the limit of the previous version.
+ */
+void float_bench(void)
+{
+  static const struct { const char *name; float range; uint8_t accuracy; const char *text; } cases[] = {
+    { "< 100", 100, 0, "0" }, { "< 100", 100, 2, "2" }, { "< 10000", 10000, 3, "3" },
+    { "< 1", 1, 6, "6" }, { "< 10", 10, 8, "8" }
+  };
+  bench_text("| values | accuracy | previous | now |\n|---|---:|---:|---:|\n");
+  bench_flush();
+  for(unsigned i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+    bench_text("| ");
+    bench_text(cases[i].name);
+    bench_text(" | ");
+    bench_text(cases[i].text);
+    bench_text(" | ");
+    bench_value(float_bench_run(cases[i].range, cases[i].accuracy, true));
+    bench_text(" | ");
+    bench_value(float_bench_run(cases[i].range, cases[i].accuracy, false));
+    bench_text(" |\n");
+    bench_flush();
+  }
+  bench_text("\n" BENCH_UNIT " per conversion\n");
+  bench_flush();
+}
+
+#ifndef OpenCPLC
+
+int main(void)
+{
+  char expected[256];
+  long errors = 0;
+  for(long i = 0; i < 20000000; i++) {
+    uint32_t bits = (uint32_t)xorshift();
+    float nbr;
+    memcpy(&nbr, &bits, sizeof(nbr));
+    if(i % 3 == 0) nbr = (float)((double)(int32_t)xorshift() / (1 << (xorshift() % 31))); // typical range
+    if(isnan(nbr) || isinf(nbr)) continue;
+    uint8_t accuracy = xorshift() % 10, width = xorshift() % 14;
+    snprintf(expected, sizeof(expected), "%*.*f", width, accuracy, (double)nbr);
+    const char *text = print(nbr, accuracy, width);
+    if(strcmp(text, expected) && errors++ < 10) printf("FAIL %a accuracy:%u width:%u \"%s\" vs \"%s\"\n", nbr, accuracy, width, text, expected);
+  }
+  const struct { float nbr; const char *text; } special[] = {
+    { NAN, "   NaN" }, { INFINITY, "   Inf" }, { -INFINITY, "  -Inf" }, { -0.0f, " -0.00" }, { 2.5f, "  2.50" }
+  };
+  for(unsigned i = 0; i < sizeof(special) / sizeof(special[0]); i++) {
+    const char *text = print(special[i].nbr, 2, 6);
+    if(strcmp(text, special[i].text) && errors++ < 10) printf("FAIL special \"%s\" vs \"%s\"\n", text, special[i].text);
+  }
+  file.size = file.limit - 3;
+  if(FILE_Float(&file, 1.5f, 2, 0) != 0 || file.size != file.limit - 3) errors++, printf("FAIL full buffer\n");
+  file.size = 0;
+  file.lock = true;
+  if(FILE_Float(&file, 1.5f, 2, 0) != 0 || file.size) errors++, printf("FAIL locked file\n");
+  printf("check: %s\n\n", errors ? "FAIL" : "ok");
+  if(errors) return 1;
+  float_bench();
+  printf("host CPU has hardware floating point, Cortex-M0+ calls __aeabi_fmul per multiply\n");
+  return 0;
+}
+
+#endif
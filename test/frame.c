@@ -0,0 +1,460 @@
+/**
+ * @file  frame.c
+ * @brief Host test of binary frames (`frame.c`): COBS, frame checks and windowed file transfer.
+ *        Bash, stream, debug and CRC peripheral are replaced by the stand-ins below,
+ *        `frame.c` is included directly. COBS must round-trip random data, zero-free runs
+ *        around the 254-byte block and empty input, frames with bad CRC or broken COBS
+ *        must be dropped without reply, `FileAppend` of exactly `FRAME_SIZE` must pass.
+ *        Upload and download then run over an in-order link losing 0…10% of frames
+ *        in both directions and must deliver the file byte-exact.
+ *
+ *   gcc -std=gnu11 -O2 -Wall -Itest -Ilib/ext -Ilib/sys -Ilib/per -DVRTS_POSIX=1 test/frame.c lib/ext/file.c lib/ext/extstr.c lib/ext/extmath.c lib/ext/heap.c lib/sys/vrts.c lib/sys/vrts-posix.c -lm -o frame && ./frame
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include "file.h"
+#include "vrts.h"
+
+//------------------------------------------------------------------------------------------------- stand-ins
+
+#define BASH_H_
+#define CRC_H_
+
+#define STREAM_ADDRESS 0
+#define STREAM_CRC 0
+#define BASH_ARGC_LIMIT 16
+
+typedef enum {
+  STREAM_Modify_Free = 0,
+  STREAM_Modify_Lowercase = 1,
+  STREAM_Modify_Uppercase = 2
+} STREAM_Modify_e;
+
+typedef struct {
+  const char *name;
+  STREAM_Modify_e modify;
+} STREAM_t;
+
+typedef struct {
+  uint8_t width;
+  uint32_t polynomial;
+  uint32_t initial;
+  uint8_t reflect_data_in;
+  bool reflect_data_out;
+  uint32_t final_xor;
+  bool invert_out;
+} CRC_t;
+
+const CRC_t crc16_modbus = {
+  .width = 16,
+  .polynomial = 0x8005,
+  .initial = 0xFFFF,
+  .reflect_data_in = 16,
+  .reflect_data_out = true,
+  .final_xor = 0x0000,
+  .invert_out = true
+};
+
+static uint32_t reflect(uint32_t value, uint8_t width)
+{
+  uint32_t out = 0;
+  for(uint8_t i = 0; i < width; i++) out |= ((value >> i) & 1) << (width - 1 - i);
+  return out;
+}
+
+// Bitwise model of the CRC peripheral as configured by `CRC_Run` (byte writes)
+static uint32_t CRC_Run(const CRC_t *crc, const uint8_t *data, uint16_t count)
+{
+  uint32_t top = 1u << (crc->width - 1);
+  uint32_t mask = top | (top - 1);
+  uint32_t code = crc->initial & mask;
+  while(count--) {
+    uint8_t byte = *data++;
+    if(crc->reflect_data_in) byte = (uint8_t)reflect(byte, 8);
+    code ^= (uint32_t)byte << (crc->width - 8);
+    for(uint8_t i = 0; i < 8; i++) code = (code & top) ? ((code << 1) ^ crc->polynomial) & mask : (code << 1) & mask;
+  }
+  if(crc->reflect_data_out) code = reflect(code, crc->width);
+  code ^= crc->final_xor;
+  if(crc->invert_out && crc->width == 16) code = ((code & 0xFF) << 8) | (code >> 8);
+  return code;
+}
+
+static uint16_t CRC_Append(const CRC_t *crc, uint8_t *data, uint16_t count)
+{
+  uint32_t code = CRC_Run(crc, data, count);
+  data[count++] = (uint8_t)(code >> 8);
+  data[count++] = (uint8_t)code;
+  return count;
+}
+
+static status_t CRC_Error(const CRC_t *crc, uint8_t *data, uint16_t count)
+{
+  uint32_t code = CRC_Run(crc, data, count - 2);
+  return data[count - 2] == (uint8_t)(code >> 8) && data[count - 1] == (uint8_t)code ? OK : ERR;
+}
+
+static uint8_t output_buffer[8192];
+static FILE_t output = { .name = "output", .buffer = output_buffer, .limit = sizeof(output_buffer) };
+FILE_t *DbgFile = &output;
+
+static void DBG_SetFile(FILE_t *file)
+{
+  DbgFile = file;
+}
+
+static char log_line[128];
+
+static void LOG_Bash(const char *format, ...)
+{
+  va_list args;
+  va_start(args, format);
+  vsnprintf(log_line, sizeof(log_line), format, args);
+  va_end(args);
+}
+
+#define LOG_Warning LOG_Bash
+
+static uint8_t data_buffer[4096];
+static FILE_t data_file = { .name = "data", .buffer = data_buffer, .limit = sizeof(data_buffer) };
+
+static FILE_t *BASH_FileByIndex(uint16_t index)
+{
+  return index ? NULL : &data_file;
+}
+
+static FILE_t *BASH_FileByHash(uint32_t hash)
+{
+  return hash == hash_djb2_ci(data_file.name) ? &data_file : NULL;
+}
+
+static bool BASH_Exec(STREAM_t *stream, char **argv, uint16_t argc)
+{
+  (void)stream;
+  (void)argv;
+  (void)argc;
+  return false;
+}
+
+static status_t FILE_Flash_Save(FILE_t *file)
+{
+  (void)file;
+  return ERR;
+}
+
+static status_t FILE_Flash_Load(FILE_t *file)
+{
+  (void)file;
+  return ERR;
+}
+
+#include "../lib/dev/frame.c"
+
+//------------------------------------------------------------------------------------------------- host side
+
+static int errors;
+
+static void expect(bool ok, const char *what, long n)
+{
+  if(ok) return;
+  if(errors++ < 10) printf("FAIL %s at %ld\n", what, n);
+}
+
+static STREAM_t stream = { .name = "test" };
+static uint8_t request_id;
+static uint16_t output_read;
+
+/**
+ * @brief Encode request `id op payload crc` with COBS and pass it to `FRAME_Handle`.
+ * @return Result of `FRAME_Handle`.
+ */
+static bool request(uint8_t op, const uint8_t *payload, uint16_t size)
+{
+  static uint8_t frame[FRAME_SIZE + 16], encoded[FRAME_SIZE + 32];
+  frame[0] = ++request_id;
+  frame[1] = op;
+  memcpy(&frame[2], payload, size);
+  size = CRC_Append(&FRAME_CRC, frame, size + 2);
+  return FRAME_Handle(&stream, encoded, cobs_encode(frame, size, encoded));
+}
+
+/**
+ * @brief Next reply queued in `output` as `0x00 <COBS> 0x00`, checked and without CRC.
+ * @return Size of reply, `0` when `output` is read out (then it is cleared).
+ */
+static uint16_t reply(uint8_t *frame)
+{
+  while(output_read < output.size) {
+    expect(output.buffer[output_read] == 0x00, "reply delimiter", output_read);
+    uint16_t start = ++output_read;
+    while(output_read < output.size && output.buffer[output_read]) output_read++;
+    uint16_t size = output_read - start;
+    output_read++;
+    memcpy(frame, &output.buffer[start], size);
+    size = cobs_decode(frame, size);
+    expect(size >= 5 && !CRC_Error(&FRAME_CRC, frame, size), "reply CRC", size);
+    return size - 2;
+  }
+  output.size = 0;
+  output_read = 0;
+  return 0;
+}
+
+static uint32_t data_hash(void)
+{
+  return hash_djb2_ci(data_file.name);
+}
+
+static void random_fill(uint8_t *data, uint16_t size, uint8_t zero_percent)
+{
+  for(uint16_t i = 0; i < size; i++) data[i] = rand() % 100 < zero_percent ? 0 : 1 + rand() % 255;
+}
+
+//------------------------------------------------------------------------------------------------- COBS
+
+static void cobs_check(const uint8_t *data, uint16_t size, long n)
+{
+  static uint8_t encoded[1100];
+  uint16_t encoded_size = cobs_encode(data, size, encoded);
+  expect(encoded_size <= size + size / 254 + 1, "cobs size", n);
+  expect(memchr(encoded, 0, encoded_size) == NULL, "cobs zero", n);
+  expect(cobs_decode(encoded, encoded_size) == size && !memcmp(encoded, data, size), "cobs round-trip", n);
+}
+
+static void test_cobs(void)
+{
+  static const struct { uint8_t size, data[4], encoded_size, encoded[5]; } vectors[] = {
+    { 1, { 0x00 }, 2, { 0x01, 0x01 } },
+    { 2, { 0x00, 0x00 }, 3, { 0x01, 0x01, 0x01 } },
+    { 4, { 0x11, 0x22, 0x00, 0x33 }, 5, { 0x03, 0x11, 0x22, 0x02, 0x33 } },
+    { 4, { 0x11, 0x22, 0x33, 0x44 }, 5, { 0x05, 0x11, 0x22, 0x33, 0x44 } },
+    { 4, { 0x11, 0x00, 0x00, 0x00 }, 5, { 0x02, 0x11, 0x01, 0x01, 0x01 } }
+  };
+  uint8_t encoded[1100], data[1100];
+  for(unsigned i = 0; i < sizeof(vectors) / sizeof(vectors[0]); i++) {
+    uint16_t size = cobs_encode(vectors[i].data, vectors[i].size, encoded);
+    expect(size == vectors[i].encoded_size && !memcmp(encoded, vectors[i].encoded, size), "cobs vector", i);
+    cobs_check(vectors[i].data, vectors[i].size, i);
+  }
+  // Empty input: single code byte, decodes to nothing
+  expect(cobs_encode(vectors[0].data, 0, encoded) == 1 && encoded[0] == 0x01, "cobs empty", 0);
+  expect(cobs_decode(encoded, 1) == 0, "cobs empty decode", 0);
+  // Zero-free runs around the 254-byte block, alone and between zeros
+  for(uint16_t run = 250; run <= 510; run++) {
+    if(run > 260 && run < 505) continue;
+    for(uint16_t i = 0; i < run; i++) data[i] = 1 + i % 255;
+    cobs_check(data, run, run);
+    data[run] = 0x00;
+    cobs_check(data, run + 1, run);
+    memmove(&data[1], data, run + 1);
+    data[0] = 0x00;
+    cobs_check(data, run + 2, run);
+  }
+  // 255 bytes 01…FF: one full block and one short block, same as reference encoding
+  for(uint16_t i = 0; i < 255; i++) data[i] = i + 1;
+  expect(cobs_encode(data, 255, encoded) == 257 && encoded[0] == 0xFF && encoded[255] == 0x02, "cobs 255", 0);
+  // 254 bytes 01…FE without trailing code byte (as other encoders send it) must decode too
+  encoded[0] = 0xFF;
+  for(uint16_t i = 0; i < 254; i++) encoded[i + 1] = i + 1;
+  expect(cobs_decode(encoded, 255) == 254 && encoded[0] == 1 && encoded[253] == 0xFE, "cobs 254 canonical", 0);
+  for(int n = 0; n < 20000; n++) {
+    uint16_t size = rand() % 1000;
+    random_fill(data, size, rand() % 4 ? rand() % 10 : 100);
+    cobs_check(data, size, n);
+  }
+  // Garbage must decode in bounds or be rejected
+  for(int n = 0; n < 20000; n++) {
+    uint16_t size = 1 + rand() % 600;
+    random_fill(data, size, rand() % 3);
+    expect(cobs_decode(data, size) <= size, "cobs garbage", n);
+  }
+}
+
+//------------------------------------------------------------------------------------------------- frames
+
+static void test_frames(void)
+{
+  uint8_t payload[FRAME_SIZE + 8], frame[FRAME_SIZE + 32], encoded[FRAME_SIZE + 32];
+  random_fill(payload, 100, 20);
+  expect(request(FRAME_Op_Ping, payload, 100), "ping", 0);
+  uint16_t size = reply(frame);
+  expect(size == 103 && frame[0] == request_id && frame[1] == (FRAME_Op_Ping | FRAME_REPLY) &&
+    frame[2] == FRAME_Status_Ok && !memcmp(&frame[3], payload, 100), "ping reply", size);
+  expect(!reply(frame), "single reply", 0);
+  // Bad CRC: every byte of a valid frame corrupted in turn
+  frame[0] = 1;
+  frame[1] = FRAME_Op_Ping;
+  memcpy(&frame[2], payload, 20);
+  size = CRC_Append(&FRAME_CRC, frame, 22);
+  for(uint16_t i = 0; i < size; i++) {
+    uint8_t bad[32];
+    memcpy(bad, frame, size);
+    bad[i] ^= 1 << (rand() % 8);
+    expect(!FRAME_Handle(&stream, encoded, cobs_encode(bad, size, encoded)), "bad CRC", i);
+  }
+  // Broken COBS: zero inside, code past end, frame cut short
+  uint16_t encoded_size = cobs_encode(frame, size, encoded);
+  uint8_t broken[FRAME_SIZE + 32];
+  for(uint16_t i = 0; i < encoded_size; i++) {
+    memcpy(broken, encoded, encoded_size);
+    broken[i] = 0x00;
+    expect(!FRAME_Handle(&stream, broken, encoded_size), "COBS zero", i);
+  }
+  memcpy(broken, encoded, encoded_size);
+  broken[0] = 0xFE;
+  expect(!FRAME_Handle(&stream, broken, encoded_size), "COBS code past end", 0);
+  for(uint16_t cut = 0; cut < encoded_size; cut++) {
+    // Trailing `0x00` of CRC lost with its code byte leaves shorter frame with valid CRC (no final XOR)
+    if(cut == encoded_size - 1 && !frame[size - 1]) continue;
+    memcpy(broken, encoded, encoded_size);
+    expect(!FRAME_Handle(&stream, broken, cut), "COBS cut", cut);
+  }
+  expect(output.size == 0, "reply to dropped frame", output.size);
+  // `FileAppend` of exactly `FRAME_SIZE` (id, opcode, hash, data, CRC) passes, one byte more is dropped
+  FILE_Clear(&data_file);
+  uint16_t length = FRAME_SIZE - 2 - 4 - 2;
+  FRAME_PutU32(payload, data_hash());
+  random_fill(&payload[4], length + 1, 0);
+  expect(request(FRAME_Op_FileAppend, payload, 4 + length), "append FRAME_SIZE", length);
+  size = reply(frame);
+  expect(size == 3 && frame[2] == FRAME_Status_Ok, "append reply", size);
+  expect(data_file.size == length && !memcmp(data_file.buffer, &payload[4], length), "append data", data_file.size);
+  expect(!reply(frame), "single reply", 1);
+  expect(!request(FRAME_Op_FileAppend, payload, 4 + length + 1), "append FRAME_SIZE + 1", length + 1);
+  expect(data_file.size == length && output.size == 0, "append dropped", data_file.size);
+}
+
+//------------------------------------------------------------------------------------------------- transfer
+
+static uint8_t source[4096];
+static uint32_t link_sent;
+static uint32_t link_lost;
+
+// In-order link losing `loss` percent of frames
+static bool link_pass(uint8_t loss)
+{
+  link_sent++;
+  if(rand() % 100 >= loss) return true;
+  link_lost++;
+  return false;
+}
+
+static void test_upload(uint16_t size, uint8_t window, uint8_t loss)
+{
+  uint8_t payload[FRAME_SIZE], frame[FRAME_SIZE + 32];
+  random_fill(source, size, 30);
+  memset(data_buffer, 0xAA, sizeof(data_buffer));
+  uint8_t *ptr = FRAME_PutU32(payload, data_hash());
+  ptr = FRAME_PutU16(ptr, size);
+  *ptr++ = window;
+  expect(request(FRAME_Op_Upload, payload, ptr - payload), "upload start", size);
+  uint16_t length = reply(frame);
+  expect(length == 6 && frame[2] == FRAME_Status_Ok && FRAME_U16(&frame[3]) == FRAME_CHUNK_SIZE, "upload reply", length);
+  window = frame[5];
+  reply(frame);
+  uint16_t count = (size + FRAME_CHUNK_SIZE - 1) / FRAME_CHUNK_SIZE;
+  uint16_t base = 0;
+  uint32_t mask = 0;
+  bool done = !count;
+  for(uint32_t round = 0; !done && round < 2000; round++) {
+    for(uint16_t seq = base; seq < count && seq < base + window; seq++) {
+      if(mask & (1u << (seq - base))) continue;
+      uint16_t chunk = size - seq * FRAME_CHUNK_SIZE < FRAME_CHUNK_SIZE ? size - seq * FRAME_CHUNK_SIZE : FRAME_CHUNK_SIZE;
+      ptr = FRAME_PutU16(payload, seq);
+      memcpy(ptr, &source[seq * FRAME_CHUNK_SIZE], chunk);
+      if(link_pass(loss)) request(FRAME_Op_Chunk, payload, 2 + chunk);
+    }
+    while((length = reply(frame))) {
+      if(!link_pass(loss)) continue;
+      // Transfer no longer active: last acknowledgment was lost
+      if(frame[2] == FRAME_Status_Transfer) done = true;
+      else if(frame[2] == FRAME_Status_Ok && length == 9 && FRAME_U16(&frame[3]) >= base) {
+        base = FRAME_U16(&frame[3]);
+        mask = FRAME_U32(&frame[5]);
+        done = base >= count;
+      }
+      else expect(false, "upload ack", frame[2]);
+    }
+    VrtsTicker += 10;
+  }
+  expect(done && !frame_transfer.active && frame_transfer.complete, "upload complete", size);
+  expect(data_file.size == size && !data_file.lock && !memcmp(data_file.buffer, source, size), "upload data", size);
+}
+
+static void test_download(uint16_t size, uint8_t window, uint8_t loss)
+{
+  uint8_t payload[FRAME_SIZE], frame[FRAME_SIZE + 32];
+  static uint8_t received[4096];
+  static bool got[4096 / FRAME_CHUNK_SIZE];
+  random_fill(data_buffer, size, 30);
+  data_file.size = size;
+  memset(received, 0xAA, sizeof(received));
+  memset(got, 0, sizeof(got));
+  uint8_t *ptr = FRAME_PutU32(payload, data_hash());
+  *ptr++ = window;
+  expect(request(FRAME_Op_Download, payload, ptr - payload), "download start", size);
+  uint16_t length = reply(frame);
+  expect(length == 8 && frame[2] == FRAME_Status_Ok && FRAME_U16(&frame[3]) == size, "download reply", length);
+  reply(frame);
+  uint16_t count = (size + FRAME_CHUNK_SIZE - 1) / FRAME_CHUNK_SIZE;
+  uint16_t base = 0;
+  for(uint32_t round = 0; frame_transfer.active && round < 5000; round++) {
+    FRAME_Loop(&stream);
+    while((length = reply(frame))) {
+      if(!link_pass(loss)) continue;
+      expect(frame[0] == 0 && frame[1] == (FRAME_Op_Chunk | FRAME_REPLY) && length >= 5, "download chunk", length);
+      uint16_t seq = FRAME_U16(&frame[3]);
+      expect(seq < count, "download seq", seq);
+      memcpy(&received[seq * FRAME_CHUNK_SIZE], &frame[5], length - 5);
+      got[seq] = true;
+    }
+    while(base < count && got[base]) base++;
+    uint32_t mask = 0;
+    for(uint16_t i = 0; i < 32 && base + i < count; i++) mask |= (uint32_t)got[base + i] << i;
+    ptr = FRAME_PutU16(payload, base);
+    ptr = FRAME_PutU32(ptr, mask);
+    if(link_pass(loss)) request(FRAME_Op_Ack, payload, ptr - payload);
+    expect(!output.size, "reply to ack", output.size);
+    VrtsTicker += 50;
+  }
+  expect(!frame_transfer.active && frame_transfer.complete, "download complete", size);
+  expect(base == count && !memcmp(received, data_buffer, size), "download data", size);
+}
+
+//------------------------------------------------------------------------------------------------- main
+
+int main(void)
+{
+  srand(1);
+  systick_init(1);
+  VrtsTicker = 1;
+  // Check value of CRC-16/MODBUS, low byte first on the wire
+  uint8_t check[11] = "123456789";
+  expect(CRC_Append(&FRAME_CRC, check, 9) == 11 && check[9] == 0x37 && check[10] == 0x4B, "CRC stand-in", 0);
+  test_cobs();
+  test_frames();
+  static const uint16_t sizes[] = { 0, 1, FRAME_CHUNK_SIZE - 1, FRAME_CHUNK_SIZE, FRAME_CHUNK_SIZE + 1, 1000, 4096 };
+  static const uint8_t windows[] = { 1, 8, 32 };
+  static const uint8_t losses[] = { 0, 2, 5, 10 };
+  printf("| transfer | loss | frames | lost | resend |\n");
+  printf("|---|---:|---:|---:|---:|\n");
+  for(int download = 0; download < 2; download++) {
+    for(unsigned l = 0; l < sizeof(losses); l++) {
+      link_sent = link_lost = 0;
+      uint32_t resend = 0;
+      for(unsigned s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        for(unsigned w = 0; w < sizeof(windows); w++) {
+          if(download) test_download(sizes[s], windows[w], losses[l]);
+          else test_upload(sizes[s], windows[w], losses[l]);
+          resend += frame_transfer.resend;
+        }
+      }
+      printf("| %s | %u%% | %u | %u | %u |\n", download ? "download" : "upload", losses[l], link_sent, link_lost, resend);
+    }
+  }
+  printf("\nsizes 0…4096B, windows 1, 8, 32, last: %s\n", log_line);
+  printf("check: %s\n", errors ? "FAIL" : "ok");
+  return errors ? 1 : 0;
+}
@@ -0,0 +1,129 @@
+/**
+ * @file  itoa.c
+ * @brief Host test and benchmark of `extstr.c` integer formatting.
+ *        `itoa_encode` and `itoa_length` must match the previous digit-by-digit division
+ *        formatter (kept here as reference) for random 64-bit values, bases 2…36, sign and
+ *        paddings, and `snprintf` for decimal and hex. Then prints formatting time of both.
+ *
+ *   gcc -std=gnu11 -O2 -Itest -Ilib/ext test/itoa.c lib/ext/extstr.c lib/ext/heap.c -o itoa && ./itoa
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "extstr.h"
+
+static uint64_t random64(void)
+{
+  return ((uint64_t)rand() << 42) ^ ((uint64_t)rand() << 21) ^ (uint64_t)rand();
+}
+
+//------------------------------------------------------------------------------------------------- reference
+
+// Previous `itoa_encode`: one 64-bit division per digit, text written in reverse order
+static uint8_t itoa_reference(int64_t nbr, char *str, uint8_t base, bool sign, uint8_t fill_zero, uint8_t fill_space)
+{
+  static const char digits[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+  char reversed[200];
+  uint8_t n = 0;
+  bool negative = sign && nbr < 0;
+  uint64_t unbr = negative ? 0 - (uint64_t)nbr : (uint64_t)nbr;
+  if(!fill_zero) fill_zero = 1;
+  if(fill_space < fill_zero) fill_space = fill_zero;
+  do {
+    reversed[n++] = digits[unbr % base];
+    unbr /= base;
+  } while(unbr);
+  while(n < fill_zero - negative) reversed[n++] = '0';
+  if(negative) reversed[n++] = '-';
+  while(n < fill_space) reversed[n++] = ' ';
+  for(uint8_t i = 0; i < n; i++) str[i] = reversed[n - 1 - i];
+  return n;
+}
+
+//------------------------------------------------------------------------------------------------- check
+
+static bool check(void)
+{
+  static const uint8_t bases[] = { 10, 16, 2, 8 };
+  char expected[200], text[200], printed[200];
+  for(long t = 0; t < 5000000; t++) {
+    int64_t nbr = (int64_t)(random64() >> (rand() % 64));
+    if(rand() & 1) nbr = -nbr;
+    if(t % 1000 == 0) nbr = INT64_MIN;
+    if(t % 1001 == 0) nbr = -1;
+    uint8_t base = rand() % 4 ? bases[rand() % 4] : 2 + rand() % 35;
+    bool sign = rand() & 1;
+    uint8_t fill_zero = rand() % 25, fill_space = rand() % 30;
+    uint8_t n = itoa_reference(nbr, expected, base, sign, fill_zero, fill_space);
+    uint8_t len = itoa_encode(nbr, text, base, sign, fill_zero, fill_space);
+    if(len != n || itoa_length(nbr, base, sign, fill_zero, fill_space) != n || memcmp(text, expected, n)) {
+      printf("FAIL %lld base:%u sign:%d zero:%u space:%u\n", (long long)nbr, base, sign, fill_zero, fill_space);
+      return false;
+    }
+    if(base == 10 && sign) snprintf(printed, sizeof(printed), "%*.*lld", fill_space, fill_zero, (long long)nbr);
+    else if(base == 16 && !sign) snprintf(printed, sizeof(printed), "%*.*llX", fill_space, fill_zero, (unsigned long long)nbr);
+    else continue;
+    // `printf` does not count `-` in precision and prints nothing for `%.0d` of zero
+    if(!(nbr < 0 && sign) && (nbr || fill_zero) && (strlen(printed) != n || memcmp(printed, text, n))) {
+      printf("FAIL %lld base:%u vs snprintf \"%s\"\n", (long long)nbr, base, printed);
+      return false;
+    }
+  }
+  return true;
+}
+
+//------------------------------------------------------------------------------------------------- benchmark
+
+static double now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+#define ITOA_BENCH_COUNT 4096
+
+/**
+ * @brief Formatting time of values below `limit`, best of 5 batches.
+ * @return Nanoseconds per number.
+ */
+static double bench(uint64_t limit, uint8_t base, bool reference)
+{
+  static int64_t values[ITOA_BENCH_COUNT];
+  char text[80];
+  for(int i = 0; i < ITOA_BENCH_COUNT; i++) values[i] = (int64_t)(random64() % limit);
+  double best = 1e18;
+  for(int batch = 0; batch < 5; batch++) {
+    double start = now_ns();
+    for(int r = 0; r < 50; r++) {
+      for(int i = 0; i < ITOA_BENCH_COUNT; i++) {
+        if(reference) itoa_reference(values[i], text, base, true, 0, 0);
+        else itoa_encode(values[i], text, base, true, 0, 0);
+        __asm__ volatile("" ::: "memory");
+      }
+    }
+    double time = now_ns() - start;
+    if(time < best) best = time;
+  }
+  return best / (50.0 * ITOA_BENCH_COUNT);
+}
+
+int main(void)
+{
+  srand(1);
+  if(!check()) return 1;
+  printf("check: ok\n\n");
+  printf("| values | base | division per digit | itoa_encode |\n");
+  printf("|---|---:|---:|---:|\n");
+  const struct { const char *name; uint64_t limit; uint8_t base; } cases[] = {
+    { "< 1e4", 10000, 10 }, { "< 2^31", 1ull << 31, 10 }, { "< 2^63", 1ull << 63, 10 },
+    { "< 2^31", 1ull << 31, 16 }, { "< 2^31", 1ull << 31, 7 }
+  };
+  for(unsigned i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+    printf("| %s | %u | %.1f | %.1f |\n", cases[i].name, cases[i].base,
+      bench(cases[i].limit, cases[i].base, true), bench(cases[i].limit, cases[i].base, false));
+  }
+  printf("\nns per number, host CPU has hardware divider (Cortex-M0+ calls __aeabi_uldivmod)\n");
+  return 0;
+}
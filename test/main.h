@@ -0,0 +1,14 @@
+/**
+ * @file  main.h
+ * @brief Host stand-in for the application `main.h` of PLC projects.
+ *        Lets library modules compile with host `gcc` for the tests and benchmarks in this folder.
+ */
+
+#ifndef MAIN_H_
+#define MAIN_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#endif
@@ -0,0 +1,130 @@
+/**
+ * @file  queue.c
+ * @brief Host test and benchmark of `QUEUE_t` priority modes.
+ *        Heap mode (`heap = true`) must pop keys in the same order as the sorted ring mode
+ *        for random push/pop/peek/drop sequences, both with and without `invert`, for
+ *        `TASK_t`-sized elements and capacity 1…1024. Then prints pop+push time of both modes.
+ *
+ *   gcc -std=gnu11 -O2 -Itest -Ilib/ext test/queue.c lib/ext/queue.c -o queue && ./queue
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "queue.h"
+
+// Same size and key position as `TASK_t`
+typedef struct {
+  void *handler;
+  void *arg;
+  uint64_t tick;
+  int32_t period;
+  uint32_t limit;
+  uint16_t data[4];
+} ITEM_t;
+
+static int32_t compare(const void *a, const void *b)
+{
+  uint64_t x = ((const ITEM_t *)a)->tick, y = ((const ITEM_t *)b)->tick;
+  return (x > y) - (x < y);
+}
+
+#define QUEUE_TEST_MAX 1024
+
+static ITEM_t heap_buffer[QUEUE_TEST_MAX], sorted_buffer[QUEUE_TEST_MAX];
+
+static void queue_init(QUEUE_t *heap, QUEUE_t *sorted, uint16_t capacity, bool invert)
+{
+  *heap = (QUEUE_t){ .buffer = heap_buffer, .struct_size = sizeof(ITEM_t), .capacity = capacity,
+    .invert = invert, .heap = true, .Compare = compare };
+  *sorted = *heap;
+  sorted->buffer = sorted_buffer;
+  sorted->heap = false;
+}
+
+//------------------------------------------------------------------------------------------------- check
+
+static bool check(void)
+{
+  QUEUE_t heap, sorted;
+  for(int invert = 0; invert < 2; invert++) {
+    for(uint16_t n = 1; n <= QUEUE_TEST_MAX; n *= 2) {
+      queue_init(&heap, &sorted, n, invert);
+      for(int i = 0; i < 20000; i++) {
+        int op = rand() % 8;
+        ITEM_t a = { 0 }, b = { 0 };
+        if(op < 5) {
+          a.tick = rand() % 500;
+          if(QUEUE_Push(&heap, &a) != QUEUE_Push(&sorted, &a)) return false;
+        }
+        else if(op < 7) {
+          bool x = QUEUE_Pop(&heap, &a), y = QUEUE_Pop(&sorted, &b);
+          if(x != y || (x && a.tick != b.tick)) return false;
+        }
+        else {
+          bool x = QUEUE_Peek(&heap, &a), y = QUEUE_Peek(&sorted, &b);
+          if(x != y || (x && a.tick != b.tick)) return false;
+          if(QUEUE_Drop(&heap) != QUEUE_Drop(&sorted)) return false;
+        }
+        if(QUEUE_Count(&heap) != QUEUE_Count(&sorted)) return false;
+      }
+    }
+  }
+  return true;
+}
+
+//------------------------------------------------------------------------------------------------- benchmark
+
+static double now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/**
+ * @brief Hold model, as in a scheduler: pop the first deadline, push it back later by random period.
+ *   Queue stays at `n` elements, keys are spread over the whole queue.
+ * @return Nanoseconds per pop+push pair, best of 5 batches.
+ */
+static double bench(QUEUE_t *queue, uint16_t n)
+{
+  QUEUE_Clear(queue);
+  ITEM_t item = { 0 };
+  for(uint16_t i = 0; i < n; i++) {
+    item.tick = rand() % 10000;
+    QUEUE_Push(queue, &item);
+  }
+  uint32_t rounds = 2000000 / n + 1000;
+  double best = 1e18;
+  for(int batch = 0; batch < 5; batch++) {
+    double start = now_ns();
+    for(uint32_t r = 0; r < rounds; r++) {
+      QUEUE_Pop(queue, &item);
+      item.tick += rand() % 10000;
+      QUEUE_Push(queue, &item);
+    }
+    double time = now_ns() - start;
+    if(time < best) best = time;
+  }
+  return best / rounds;
+}
+
+int main(void)
+{
+  srand(1);
+  if(!check()) {
+    printf("FAIL heap and sorted mode differ\n");
+    return 1;
+  }
+  printf("check: ok\n\n");
+  printf("| n | sorted | heap |\n");
+  printf("|---:|---:|---:|\n");
+  for(uint16_t n = 16; n <= QUEUE_TEST_MAX; n *= 2) {
+    QUEUE_t heap, sorted;
+    queue_init(&heap, &sorted, n, true);
+    printf("| %u | %.0f | %.0f |\n", n, bench(&sorted, n), bench(&heap, n));
+  }
+  printf("\nns per pop+push, %u-byte elements\n", (unsigned)sizeof(ITEM_t));
+  return 0;
+}
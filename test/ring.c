@@ -0,0 +1,144 @@
+/**
+ * @file  ring.c
+ * @brief Host test and benchmark of division-free ring indexing and bulk operations.
+ *        `QUEUE_PushN`/`QUEUE_PopN` and `ring16_push_n`/`ring16_pop_n`/`ring16_copy_last` must
+ *        leave the same data and indices as the single-step functions for capacity 1…40,
+ *        including a ring type generated here with `ring_declare`/`ring_define`.
+ *        Then prints FIFO transfer time of bulk and single-step `QUEUE_t` calls.
+ *
+ *   gcc -std=gnu11 -O2 -Itest -Ilib/ext test/ring.c lib/ext/queue.c lib/ext/ring.c -o ring && ./ring
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "queue.h"
+#include "ring.h"
+
+ring_declare(ring32, uint32_t);
+ring_define(ring32, uint32_t)
+
+#define RING_TEST_MAX 64
+
+//------------------------------------------------------------------------------------------------- check
+
+static bool check_queue(uint16_t cap)
+{
+  static uint32_t bulk_buffer[RING_TEST_MAX], step_buffer[RING_TEST_MAX];
+  QUEUE_t bulk = { .buffer = bulk_buffer, .struct_size = 4, .capacity = cap };
+  QUEUE_t step = bulk;
+  step.buffer = step_buffer;
+  uint32_t value = 0;
+  for(int i = 0; i < 20000; i++) {
+    uint16_t n = rand() % (cap + 3);
+    uint32_t a[RING_TEST_MAX], b[RING_TEST_MAX];
+    if(rand() & 1) {
+      for(uint16_t k = 0; k < n; k++) a[k] = value++;
+      uint16_t pushed = 0;
+      for(uint16_t k = 0; k < n; k++) pushed += QUEUE_Push(&step, &a[k]);
+      if(QUEUE_PushN(&bulk, a, n) != pushed) return false;
+    }
+    else {
+      uint16_t popped = 0;
+      while(popped < n && QUEUE_Pop(&step, &b[popped])) popped++;
+      if(QUEUE_PopN(&bulk, a, n) != popped || memcmp(a, b, popped * 4)) return false;
+    }
+    if(bulk.count != step.count || bulk.head != step.head || bulk.tail != step.tail) return false;
+  }
+  return true;
+}
+
+// Same sequence on `ring16_t` and generated `ring32_t`, bulk against single step
+static bool check_ring(uint16_t cap)
+{
+  static uint16_t bulk_memory[RING_TEST_MAX], step_memory[RING_TEST_MAX];
+  static uint32_t wide_memory[RING_TEST_MAX];
+  ring16_t bulk = { bulk_memory, cap, 0, 0, 0 }, step = { step_memory, cap, 0, 0, 0 };
+  ring32_t wide = { wide_memory, cap, 0, 0, 0 };
+  uint16_t value = 0;
+  for(int i = 0; i < 20000; i++) {
+    uint16_t n = rand() % (cap + 3);
+    uint16_t a[RING_TEST_MAX], b[RING_TEST_MAX];
+    uint32_t w[RING_TEST_MAX];
+    if(rand() & 1) {
+      for(uint16_t k = 0; k < n; k++) a[k] = value++;
+      for(uint16_t k = 0; k < n; k++) ring16_push(&step, a[k]);
+      for(uint16_t k = 0; k < n; k++) w[k] = a[k];
+      ring16_push_n(&bulk, a, n);
+      ring32_push_n(&wide, w, n);
+    }
+    else if(rand() & 1) {
+      uint16_t x = ring16_copy_last(&bulk, n, a), y = ring16_copy_last(&step, n, b);
+      uint16_t z = ring32_copy_last(&wide, n, w);
+      if(x != y || x != z || memcmp(a, b, x * 2)) return false;
+      for(uint16_t k = 0; k < z; k++) if(w[k] != a[k]) return false;
+    }
+    else {
+      uint16_t popped = 0;
+      while(popped < n && ring16_pop(&step, &b[popped])) popped++;
+      if(ring16_pop_n(&bulk, a, n) != popped || memcmp(a, b, popped * 2)) return false;
+      if(ring32_pop_n(&wide, w, n) != popped) return false;
+      for(uint16_t k = 0; k < popped; k++) if(w[k] != a[k]) return false;
+    }
+    uint16_t first, last;
+    if(ring16_peek(&bulk, &first) != ring16_peek(&step, &last) || (bulk.count && first != last)) return false;
+    if(bulk.count != step.count || bulk.head != step.head || bulk.tail != step.tail) return false;
+    if(wide.count != step.count || wide.head != step.head || wide.tail != step.tail) return false;
+  }
+  return true;
+}
+
+//------------------------------------------------------------------------------------------------- benchmark
+
+static double now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/**
+ * @brief Moves `n` 4-byte elements through 256-element FIFO (push then pop), best of 5 batches.
+ * @return Nanoseconds per element.
+ */
+static double bench(uint16_t n, bool bulk)
+{
+  static uint32_t buffer[256], data[256];
+  QUEUE_t queue = { .buffer = buffer, .struct_size = 4, .capacity = 256 };
+  uint32_t rounds = 4000000 / n;
+  double best = 1e18;
+  for(int batch = 0; batch < 5; batch++) {
+    double start = now_ns();
+    for(uint32_t r = 0; r < rounds; r++) {
+      if(bulk) {
+        QUEUE_PushN(&queue, data, n);
+        QUEUE_PopN(&queue, data, n);
+      }
+      else {
+        for(uint16_t k = 0; k < n; k++) QUEUE_Push(&queue, &data[k]);
+        for(uint16_t k = 0; k < n; k++) QUEUE_Pop(&queue, &data[k]);
+      }
+      __asm__ volatile("" ::: "memory");
+    }
+    double time = now_ns() - start;
+    if(time < best) best = time;
+  }
+  return best / rounds / n;
+}
+
+int main(void)
+{
+  srand(1);
+  for(uint16_t cap = 1; cap <= 40; cap++) {
+    if(!check_queue(cap) || !check_ring(cap)) {
+      printf("FAIL capacity:%u\n", cap);
+      return 1;
+    }
+  }
+  printf("check: ok\n\n");
+  printf("| n | single step | bulk |\n");
+  printf("|---:|---:|---:|\n");
+  for(uint16_t n = 4; n <= 128; n *= 2) printf("| %u | %.2f | %.2f |\n", n, bench(n, false), bench(n, true));
+  printf("\nns per element, QUEUE_t of uint32_t\n");
+  return 0;
+}
@@ -0,0 +1,79 @@
+/**
+ * @file  select.c
+ * @brief Host test of `extmath.c` selection: `select_u16`, `avg_rank_u16` and `trimmed_mean_u16`
+ *        must give bit-exact the same result as full `sort_asc_u16` followed by `avg_u16`
+ *        on random, duplicate-heavy, presorted, reversed and narrow ADC-like input.
+ *
+ *   gcc -std=gnu11 -O2 -Itest -Ilib/ext test/select.c lib/ext/extmath.c -lm -o select && ./select
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "extmath.h"
+
+#define SELECT_TEST_MAX 3000
+
+static uint16_t input[SELECT_TEST_MAX], sorted[SELECT_TEST_MAX], work[SELECT_TEST_MAX];
+
+static uint16_t fill(int kind, uint16_t i, uint16_t n)
+{
+  switch(kind) {
+    case 0: return (uint16_t)rand(); // random
+    case 1: return rand() % 5; // duplicate-heavy
+    case 2: return i; // presorted
+    case 3: return n - i; // reversed
+    default: return 2048 + rand() % 40; // ADC-like noise around one level
+  }
+}
+
+//------------------------------------------------------------------------------------------------- check
+
+static bool check_select(uint16_t n, uint16_t k)
+{
+  memcpy(work, input, n * 2);
+  select_u16(work, n, k);
+  if(work[k] != sorted[k]) return false;
+  for(uint16_t i = 0; i < k; i++) if(work[i] > work[k]) return false;
+  for(uint16_t i = k + 1; i < n; i++) if(work[i] < work[k]) return false;
+  return true;
+}
+
+static bool check_rank(uint16_t n, uint16_t begin, uint16_t end)
+{
+  memcpy(work, input, n * 2);
+  float value = avg_rank_u16(work, n, begin, end);
+  float expected = begin < end && end <= n ? avg_u16(&sorted[begin], end - begin) : 0.0f;
+  return !memcmp(&value, &expected, sizeof(float));
+}
+
+static bool check_trimmed(uint16_t n, float lo_frac, float hi_frac)
+{
+  memcpy(work, input, n * 2);
+  float value = trimmed_mean_u16(work, n, lo_frac, hi_frac);
+  uint16_t lo = (uint16_t)(n * lo_frac), hi = (uint16_t)(n * hi_frac);
+  float expected = (uint32_t)lo + hi < n ? avg_u16(&sorted[lo], n - lo - hi) : 0.0f;
+  return !memcmp(&value, &expected, sizeof(float));
+}
+
+int main(void)
+{
+  srand(1);
+  const float fracs[] = { 0.0f, 0.1f, 0.25f, 1.0f / 3, 0.5f };
+  for(int t = 0; t < 100000; t++) {
+    uint16_t n = 1 + rand() % (t < 80000 ? 100 : SELECT_TEST_MAX);
+    int kind = rand() % 5;
+    for(uint16_t i = 0; i < n; i++) input[i] = fill(kind, i, n);
+    memcpy(sorted, input, n * 2);
+    sort_asc_u16(sorted, n);
+    uint16_t k = rand() % n;
+    uint16_t begin = rand() % n, end = begin + rand() % (n - begin + 1);
+    float lo_frac = fracs[rand() % 5], hi_frac = fracs[rand() % 5];
+    if(!check_select(n, k) || !check_rank(n, begin, end) || !check_rank(n, n / 3, 2 * (n / 3)) ||
+      !check_trimmed(n, lo_frac, hi_frac)) {
+      printf("FAIL kind:%d n:%u k:%u rank:[%u,%u) trim:%.3f/%.3f\n", kind, n, k, begin, end, lo_frac, hi_frac);
+      return 1;
+    }
+  }
+  printf("check: ok\n");
+  return 0;
+}
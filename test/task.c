@@ -0,0 +1,148 @@
+/**
+ * @file  task.c
+ * @brief Host test of the `task.c` timer wheel on the POSIX port (`vrts-posix.c`).
+ *        Virtual clock advances only while all threads wait, so every task must run at
+ *        exactly its due tick: 400 tasks pending at once with delays over all 4 wheel levels
+ *        and beyond the horizon, periodic re-arm without drift and cancel from own handler,
+ *        cancel/reschedule by stale handle after the pool slot is reused.
+ *        `TASK_Main` must stay blocked between deadlines (few wake-ups per task).
+ *
+ *   gcc -std=gnu11 -O2 -Itest -Ilib/sys -DVRTS_POSIX=1 -DVRTS_POSIX_LETS_PER_TICK=1000000000 -DTASK_LIMIT=512 test/task.c lib/sys/task.c lib/sys/vrts.c lib/sys/vrts-posix.c -o task && ./task
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "task.h"
+
+stack(stack_wheel, 256);
+stack(stack_test, 256);
+
+static int errors;
+
+static void expect(bool ok, const char *what, long n)
+{
+  if(ok) return;
+  if(errors++ < 10) printf("FAIL %s at %ld\n", what, n);
+}
+
+typedef struct {
+  uint64_t due;
+  uint64_t ran;
+  uint32_t count;
+} RECORD_t;
+
+static void record(void *arg)
+{
+  RECORD_t *rec = arg;
+  rec->ran = tick_read();
+  rec->count++;
+}
+
+//------------------------------------------------------------------------------------------------- levels
+
+#define TASK_TEST_COUNT 400
+
+static void test_levels(void)
+{
+  static RECORD_t recs[TASK_TEST_COUNT];
+  // Both sides of every level boundary (64^n ticks), then random delays up to past the horizon
+  static const uint32_t edges[] = { 1, 2, 63, 64, 65, 4095, 4096, 4097, 262143, 262144, 262145,
+    16777215, 16777216, 16777217, 20000000 };
+  uint32_t n = sizeof(edges) / sizeof(edges[0]);
+  uint64_t last = 0;
+  for(uint32_t i = 0; i < TASK_TEST_COUNT; i++) {
+    uint32_t delay_ms = i < n ? edges[i] : 1 + (uint32_t)rand() % (rand() % 4 ? 1 << (6 * (1 + rand() % 4)) : 20000000);
+    recs[i].due = tick_read() + delay_ms;
+    if(recs[i].due > last) last = recs[i].due;
+    expect(TASK_Add(record, &recs[i], delay_ms) != 0, "TASK_Add", i);
+    if(i % 50 == 49) delay(1 + rand() % 300); // Add some tasks while the wheel is running
+  }
+  uint16_t pending = 0;
+  for(uint32_t i = 0; i < TASK_TEST_COUNT; i++) pending += !recs[i].count;
+  expect(TASK_Count() == pending && pending > 300, "TASK_Count", pending);
+  delay(last - tick_read() + 1);
+  for(uint32_t i = 0; i < TASK_TEST_COUNT; i++) {
+    expect(recs[i].count == 1, "count", i);
+    expect(recs[i].ran == recs[i].due, "due tick", i);
+  }
+  expect(TASK_Count() == 0, "TASK_Count empty", TASK_Count());
+}
+
+//------------------------------------------------------------------------------------------------- periodic
+
+static RECORD_t periodic;
+static TASK_Handle_t periodic_handle;
+static uint64_t periodic_start;
+
+static void periodic_run(void *arg)
+{
+  (void)arg;
+  uint64_t now = tick_read();
+  expect(now == periodic_start + 7 * (periodic.count + 1), "periodic tick", periodic.count);
+  periodic.count++;
+  if(periodic.count == 100) expect(TASK_Cancel(periodic_handle), "cancel from handler", 0);
+}
+
+static void test_periodic(void)
+{
+  periodic_start = tick_read();
+  periodic_handle = TASK_AddPeriodic(periodic_run, NULL, 7);
+  delay(2000);
+  expect(periodic.count == 100, "periodic count", periodic.count);
+  expect(!TASK_IsPending(periodic_handle), "periodic cancelled", 0);
+}
+
+//------------------------------------------------------------------------------------------------- handles
+
+static void test_handles(void)
+{
+  RECORD_t a = { 0 }, b = { 0 }, c = { 0 };
+  TASK_Handle_t ha = TASK_Add(record, &a, 100);
+  expect(TASK_IsPending(ha), "pending", 0);
+  expect(TASK_Cancel(ha), "cancel", 0);
+  expect(!TASK_Cancel(ha) && !TASK_IsPending(ha), "cancel twice", 0);
+  expect(!TASK_Reschedule(ha, 10), "reschedule cancelled", 0);
+  TASK_Handle_t hb = TASK_Add(record, &b, 100); // Takes the slot freed by `a`
+  expect((hb & 0xFFFF) == (ha & 0xFFFF) && hb != ha, "slot reuse", 0);
+  expect(!TASK_Cancel(ha) && TASK_IsPending(hb), "stale cancel", 0);
+  expect(!TASK_Reschedule(ha, 10) && TASK_IsPending(hb), "stale reschedule", 0);
+  uint64_t start = tick_read();
+  expect(TASK_Reschedule(hb, 300), "reschedule", 0); // Later, crossing into level 1
+  TASK_Handle_t hc = TASK_Add(record, &c, 500);
+  expect(TASK_Reschedule(hc, 20), "reschedule earlier", 0);
+  delay(400);
+  expect(a.count == 0, "cancelled ran", a.count);
+  expect(b.count == 1 && b.ran == start + 300, "rescheduled tick", b.ran - start);
+  expect(c.count == 1 && c.ran == start + 20, "rescheduled earlier tick", c.ran - start);
+  expect(!TASK_IsPending(hb) && !TASK_Cancel(hb) && !TASK_Reschedule(hb, 10), "handle after run", 0);
+  expect(TASK_Add(record, &a, 0) == 0 && a.count == 1, "zero delay", 0);
+}
+
+//------------------------------------------------------------------------------------------------- main
+
+static void thread_wheel(void)
+{
+  TASK_Main();
+}
+
+static void thread_test(void)
+{
+  srand(1);
+  test_handles();
+  test_periodic();
+  test_levels();
+  vrts_posix_stop();
+}
+
+int main(void)
+{
+  systick_init(1);
+  thread(thread_wheel, stack_wheel);
+  thread(thread_test, stack_test);
+  vrts_init();
+  uint64_t lets = vrts_posix_lets();
+  printf("ticks:%llu lets:%llu\n", (unsigned long long)VrtsTicker, (unsigned long long)lets);
+  expect(lets < 20 * TASK_TEST_COUNT, "TASK_Main woke too often", (long)lets);
+  printf("check: %s\n", errors ? "FAIL" : "ok");
+  return errors ? 1 : 0;
+}
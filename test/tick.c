@@ -0,0 +1,168 @@
+/**
+ * @file  tick.c
+ * @brief Host test of the VRTS timebase conversions on the POSIX port.
+ *        `tick_span`/`tick_keep` (reciprocal multiply instead of division) must equal
+ *        `ceil(ms / tick_ms)` for every `tick_ms` 1…1999 and `ms` across the whole `uint32_t` range,
+ *        `tick_to_ms`, `tick_diff` and `tick_us` must agree with `VrtsTicker`.
+ *        Then prints call time of the `tick_*` helpers next to the previous division-based
+ *        and plain-read versions (kept here as reference), with a shift-subtract division
+ *        standing in for the division routine of Cortex-M0+.
+ *
+ *   gcc -std=gnu11 -O2 -Itest -Ilib/sys -DVRTS_POSIX=1 test/tick.c lib/sys/vrts.c lib/sys/vrts-posix.c -o tick && ./tick
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "vrts.h"
+
+static bool check_span(uint32_t tick_ms, uint32_t ms)
+{
+  uint32_t expected = (uint32_t)(((uint64_t)ms + tick_ms - 1) / tick_ms);
+  if(tick_span(ms) == expected && tick_keep(ms) == VrtsTicker + expected) return true;
+  printf("FAIL tick_ms:%u ms:%u span:%u expected:%u\n", tick_ms, ms, tick_span(ms), expected);
+  return false;
+}
+
+//------------------------------------------------------------------------------------------------- reference
+
+static uint32_t reference_tick_ms;
+
+// Shift-subtract division, stand-in for `__aeabi_uidiv` of Cortex-M0+ (no divide instruction)
+__attribute__((noinline)) static uint32_t udiv_soft(uint32_t n, uint32_t d)
+{
+  uint32_t q = 0, bit = 1;
+  while(d < n && !(d & 0x80000000)) {
+    d <<= 1;
+    bit <<= 1;
+  }
+  while(bit) {
+    if(n >= d) {
+      n -= d;
+      q |= bit;
+    }
+    d >>= 1;
+    bit >>= 1;
+  }
+  return q;
+}
+
+// Previous `tick_keep`: plain 64-bit read, one division per call
+__attribute__((noinline)) static uint64_t keep_reference(uint32_t offset_ms)
+{
+  return VrtsTicker + ((offset_ms + (reference_tick_ms - 1)) / reference_tick_ms);
+}
+
+__attribute__((noinline)) static uint32_t span_reference(uint32_t ms)
+{
+  return (ms + (reference_tick_ms - 1)) / reference_tick_ms;
+}
+
+// Previous `tick_over`: plain 64-bit read (tears on Cortex-M0+)
+__attribute__((noinline)) static bool over_reference(uint64_t *tick)
+{
+  if(!*tick || *tick > VrtsTicker) return false;
+  *tick = 0;
+  return true;
+}
+
+//------------------------------------------------------------------------------------------------- benchmark
+
+static double now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+#define TICK_BENCH_COUNT 4096
+
+static uint32_t values[TICK_BENCH_COUNT];
+static volatile uint64_t sink;
+
+/**
+ * @brief Call time of `helper` for `TICK_BENCH_COUNT` random `ms` values, best of 5 batches.
+ * @return Nanoseconds per call.
+ */
+static double bench(uint64_t (*helper)(uint32_t))
+{
+  double best = 1e18;
+  for(int batch = 0; batch < 5; batch++) {
+    uint64_t sum = 0;
+    double start = now_ns();
+    for(int r = 0; r < 200; r++) {
+      for(int i = 0; i < TICK_BENCH_COUNT; i++) sum += helper(values[i]);
+    }
+    double time = now_ns() - start;
+    sink = sum;
+    if(time < best) best = time;
+  }
+  return best / (200.0 * TICK_BENCH_COUNT);
+}
+
+static uint64_t read_new(uint32_t ms) { return tick_read() + ms; }
+static uint64_t read_old(uint32_t ms) { return VrtsTicker + ms; }
+static uint64_t keep_new(uint32_t ms) { return tick_keep(ms); }
+static uint64_t keep_old(uint32_t ms) { return keep_reference(ms); }
+static uint64_t span_new(uint32_t ms) { return tick_span(ms); }
+static uint64_t span_old(uint32_t ms) { return span_reference(ms); }
+static uint64_t keep_soft(uint32_t ms) { return VrtsTicker + udiv_soft(ms + reference_tick_ms - 1, reference_tick_ms); }
+static uint64_t span_soft(uint32_t ms) { return udiv_soft(ms + reference_tick_ms - 1, reference_tick_ms); }
+static uint64_t over_new(uint32_t ms) { uint64_t tick = VrtsTicker + (ms & 1); return tick_over(&tick); }
+static uint64_t over_old(uint32_t ms) { uint64_t tick = VrtsTicker + (ms & 1); return over_reference(&tick); }
+static uint64_t us_new(uint32_t ms) { return tick_us() + ms; }
+
+int main(void)
+{
+  srand(1);
+  for(uint32_t tick_ms = 1; tick_ms < 2000; tick_ms++) {
+    systick_init(tick_ms);
+    VrtsTicker = ((uint64_t)rand() << 20) ^ rand();
+    // Edges around multiples of `tick_ms` and of the reciprocal error, then random values
+    for(uint32_t k = 0; k < 64; k++) {
+      uint32_t base = k * tick_ms;
+      if(!check_span(tick_ms, base) || !check_span(tick_ms, base + 1) || (base && !check_span(tick_ms, base - 1)))
+        return 1;
+    }
+    uint32_t top = UINT32_MAX - UINT32_MAX % tick_ms;
+    if(!check_span(tick_ms, UINT32_MAX) || !check_span(tick_ms, top) || !check_span(tick_ms, top - 1)) return 1;
+    for(int i = 0; i < 20000; i++) {
+      uint32_t ms = ((uint32_t)rand() << 16) ^ (uint32_t)rand();
+      if(!check_span(tick_ms, ms >> (rand() % 32))) return 1;
+    }
+    uint64_t now = VrtsTicker;
+    if(tick_to_ms(now) != (uint32_t)(now * tick_ms) || tick_us() != now * tick_ms * 1000 ||
+      tick_diff(now - 7) != (int32_t)(7 * tick_ms) || tick_read() != now) {
+      printf("FAIL tick_ms:%u conversions\n", tick_ms);
+      return 1;
+    }
+  }
+  printf("check: ok\n\n");
+  systick_init(10); // `tick_ms > 1` takes the reciprocal path
+  reference_tick_ms = 10;
+  for(int i = 0; i < TICK_BENCH_COUNT; i++) {
+    values[i] = (uint32_t)rand() % 100000;
+    if(span_soft(values[i]) != span_reference(values[i])) {
+      printf("FAIL udiv_soft %u\n", values[i]);
+      return 1;
+    }
+  }
+  const struct { const char *name; uint64_t (*now)(uint32_t); uint64_t (*old)(uint32_t); uint64_t (*soft)(uint32_t); } cases[] = {
+    { "tick_read", read_new, read_old, NULL }, { "tick_keep", keep_new, keep_old, keep_soft },
+    { "tick_span", span_new, span_old, span_soft }, { "tick_over", over_new, over_old, NULL },
+    { "tick_us", us_new, NULL, NULL }
+  };
+  printf("| helper | previous | previous, soft division | now |\n");
+  printf("|---|---:|---:|---:|\n");
+  for(unsigned i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+    printf("| %s |", cases[i].name);
+    if(cases[i].old) printf(" %.2f |", bench(cases[i].old));
+    else printf(" - |");
+    if(cases[i].soft) printf(" %.2f |", bench(cases[i].soft));
+    else printf(" - |");
+    printf(" %.2f |\n", bench(cases[i].now));
+  }
+  printf("\nns per call, tick_ms 10; host CPU has a hardware divider, soft division stands in for\n");
+  printf("__aeabi_uidiv of Cortex-M0+\n");
+  return 0;
+}
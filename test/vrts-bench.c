@@ -0,0 +1,181 @@
+/**
+ * @file  vrts-bench.c
+ * @brief Host benchmark of VRTS on the POSIX port (`vrts-posix.c`) with the virtual clock.
+ *        Yield cost: host ns per `let()` (`swapcontext` based, so only relative on target),
+ *        fairness: spread of per-thread `let` counts for N = 2…`VRTS_THREAD_LIMIT - 1` busy threads,
+ *        wake latency: ticks from due time (or `vrts_notify`) until `delay`, `timeout` or
+ *        a `vrts_block` waiter runs again, with 0…8 busy threads competing.
+ *
+ *   gcc -std=gnu11 -O2 -Itest -Ilib/sys -DVRTS_POSIX=1 test/vrts-bench.c lib/sys/vrts.c lib/sys/vrts-posix.c -o vrts-bench && ./vrts-bench
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "vrts.h"
+
+stack(stack_main, 256);
+static uint32_t stacks[VRTS_THREAD_LIMIT][256];
+
+static volatile bool stop;
+static volatile uint64_t counts[VRTS_THREAD_LIMIT];
+
+static double now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void thread_busy(void)
+{
+  uint8_t i = vrts_active_thread();
+  while(!stop) {
+    counts[i]++;
+    let();
+  }
+}
+
+// Starts `n` busy threads next to the calling one
+static void busy_start(uint8_t n)
+{
+  stop = false;
+  for(uint8_t i = 0; i < VRTS_THREAD_LIMIT; i++) counts[i] = 0;
+  for(uint8_t i = 0; i < n; i++) vrts_thread(thread_busy, stacks[i], 256);
+}
+
+// Stops all threads except the calling one and waits until they are reaped
+static void busy_stop(void)
+{
+  stop = true;
+  while(vrts_thread_count() > 1) let();
+}
+
+//------------------------------------------------------------------------------------------------- yield, fairness
+
+#define BENCH_LETS 2000000
+
+/**
+ * @brief Calling thread and `n - 1` busy threads `let()` in a loop for `BENCH_LETS` switches.
+ * @return Nanoseconds per `let()`, `min`/`max` get lowest and highest per-thread count.
+ */
+static double bench_yield(uint8_t n, uint64_t *min, uint64_t *max)
+{
+  busy_start(n - 1);
+  uint8_t self = vrts_active_thread();
+  uint64_t start = vrts_posix_lets();
+  double time = now_ns();
+  while(vrts_posix_lets() - start < BENCH_LETS) {
+    counts[self]++;
+    let();
+  }
+  time = now_ns() - time;
+  uint64_t lets = vrts_posix_lets() - start;
+  busy_stop();
+  *min = UINT64_MAX;
+  *max = 0;
+  for(uint8_t i = 0; i < n; i++) {
+    if(counts[i] < *min) *min = counts[i];
+    if(counts[i] > *max) *max = counts[i];
+  }
+  return time / lets;
+}
+
+//------------------------------------------------------------------------------------------------- latency
+
+#define BENCH_WAITS 500
+
+static uint8_t event;
+static volatile uint32_t woken;
+static volatile uint64_t woken_tick;
+
+static void thread_waiter(void)
+{
+  while(!stop) {
+    vrts_block(&event, 0);
+    let();
+    vrts_block(NULL, 0);
+    woken_tick = tick_read();
+    woken++;
+  }
+}
+
+static bool never(void *subject)
+{
+  (void)subject;
+  return false;
+}
+
+typedef struct {
+  uint64_t sum;
+  uint64_t max;
+} LATENCY_t;
+
+static void latency_add(LATENCY_t *latency, uint64_t ticks)
+{
+  latency->sum += ticks;
+  if(ticks > latency->max) latency->max = ticks;
+}
+
+/**
+ * @brief Wake latency in ticks with `n` busy threads competing.
+ * @param[out] result `delay`, `timeout` and `vrts_notify` latencies.
+ */
+static void bench_latency(uint8_t n, LATENCY_t result[3])
+{
+  busy_start(n);
+  vrts_thread(thread_waiter, stacks[n], 256);
+  for(int i = 0; i < BENCH_WAITS; i++) {
+    uint32_t ms = 1 + rand() % 20;
+    uint64_t end = tick_read() + ms;
+    delay(ms);
+    latency_add(&result[0], tick_read() - end);
+    end = tick_read() + ms;
+    timeout(ms, never, NULL);
+    latency_add(&result[1], tick_read() - end);
+    uint32_t before = woken;
+    uint64_t tick = tick_read();
+    vrts_notify(&event);
+    while(woken == before) let();
+    latency_add(&result[2], woken_tick - tick);
+  }
+  stop = true;
+  vrts_notify(&event);
+  busy_stop();
+}
+
+//------------------------------------------------------------------------------------------------- main
+
+static void thread_main(void)
+{
+  srand(1);
+  printf("| threads | ns per let | let count min | let count max | spread |\n");
+  printf("|---:|---:|---:|---:|---:|\n");
+  for(uint8_t n = 2; n <= VRTS_THREAD_LIMIT - 1; n++) {
+    uint64_t min, max;
+    double ns = bench_yield(n, &min, &max);
+    printf("| %u | %.1f | %llu | %llu | %.2f%% |\n", n, ns, (unsigned long long)min,
+      (unsigned long long)max, 100.0 * (max - min) / max);
+  }
+  printf("\nhost ns per let(), mostly `swapcontext` signal-mask syscalls, %u lets per run\n\n", BENCH_LETS);
+  printf("| busy threads | delay avg | delay max | timeout avg | timeout max | notify avg | notify max |\n");
+  printf("|---:|---:|---:|---:|---:|---:|---:|\n");
+  for(uint8_t n = 0; n <= 8; n += 2) {
+    LATENCY_t result[3] = { 0 };
+    bench_latency(n, result);
+    printf("| %u | %.2f | %llu | %.2f | %llu | %.2f | %llu |\n", n,
+      (double)result[0].sum / BENCH_WAITS, (unsigned long long)result[0].max,
+      (double)result[1].sum / BENCH_WAITS, (unsigned long long)result[1].max,
+      (double)result[2].sum / BENCH_WAITS, (unsigned long long)result[2].max);
+  }
+  printf("\nwake latency in ticks after due time or notify, %u lets per tick\n", VRTS_POSIX_LETS_PER_TICK);
+  vrts_posix_stop();
+}
+
+int main(void)
+{
+  systick_init(1);
+  thread(thread_main, stack_main);
+  vrts_init();
+  return 0;
+}
@@ -0,0 +1,70 @@
+/**
+ * @file  vrts.c
+ * @brief Host test of VRTS on the POSIX port (`vrts-posix.c`) with the virtual clock.
+ *        Three threads share 1000 ticks: `delay(100)` and `delay(10)` loops must run
+ *        exactly 10 and about 100 times, a busy `let()` loop takes the rest, a thread blocked
+ *        with `vrts_block` runs once per `vrts_notify` only, a thread that returns is removed,
+ *        and `vrts_init()` returns after `vrts_posix_stop()`.
+ *
+ *   gcc -std=gnu11 -O2 -Itest -Ilib/sys -DVRTS_POSIX=1 test/vrts.c lib/sys/vrts.c lib/sys/vrts-posix.c -o vrts && ./vrts
+ */
+
+#include <stdio.h>
+#include "vrts.h"
+
+stack(stack_main, 256);
+stack(stack_busy, 256);
+stack(stack_fast, 256);
+stack(stack_once, 256);
+stack(stack_wait, 256);
+
+static volatile uint32_t slow, busy, fast, once, woken;
+static uint8_t event;
+static uint64_t ticks, lets;
+static uint8_t threads_before, threads_after;
+
+static void thread_busy(void) { while(1) { busy++; let(); } }
+static void thread_fast(void) { while(1) { fast++; delay(10); } }
+static void thread_once(void) { for(int i = 0; i < 5; i++) let(); once++; }
+
+static void thread_wait(void)
+{
+  while(1) {
+    vrts_block(&event, 0);
+    let();
+    vrts_block(NULL, 0);
+    woken++;
+  }
+}
+
+static void thread_main(void)
+{
+  threads_before = vrts_thread_count();
+  uint64_t start = VrtsTicker;
+  while(VrtsTicker - start < 1000) {
+    slow++;
+    vrts_notify(&event); // First one comes before `thread_wait` has blocked
+    delay(100);
+  }
+  ticks = VrtsTicker - start;
+  lets = vrts_posix_lets();
+  threads_after = vrts_thread_count();
+  vrts_posix_stop();
+}
+
+int main(void)
+{
+  systick_init(1);
+  thread(thread_main, stack_main);
+  thread(thread_busy, stack_busy);
+  thread(thread_fast, stack_fast);
+  thread(thread_once, stack_once);
+  thread(thread_wait, stack_wait);
+  vrts_init();
+  printf("ticks:%llu lets:%llu slow:%u fast:%u busy:%u woken:%u threads:%u→%u\n", (unsigned long long)ticks,
+    (unsigned long long)lets, slow, fast, busy, woken, threads_before, threads_after);
+  bool ok = ticks == 1000 && slow == 10 && fast >= 99 && fast <= 101 && busy > 1000 && once == 1 && woken == slow - 1 &&
+    threads_after == threads_before - 1;
+  printf("check: %s\n", ok ? "ok" : "FAIL");
+  return ok ? 0 : 1;
+}